@@ -0,0 +1,561 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+// Micro-benchmarks of the library against the same work done through the
+// SQLite C API directly. Every case prints one line in `key=value` form,
+//
+//   bench=<case> impl=<federlieb|raw> ops=<n> seconds=<s> ns_per_op=<ns>
+//   checksum=<c>
+//
+// where the checksum lets a reader tell that both variants did the same
+// work. The optional argument, a positive integer, scales the number of
+// operations.
+
+template<typename F>
+void
+measure(char const* const name,
+        char const* const impl,
+        int64_t const ops,
+        F&& f)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  int64_t checksum = f();
+
+  auto elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  std::cout << "bench=" << name << " impl=" << impl << " ops=" << ops
+            << " seconds=" << elapsed
+            << " ns_per_op=" << (ops ? elapsed * 1e9 / ops : 0)
+            << " checksum=" << checksum << '\n';
+}
+
+sqlite3_stmt*
+raw_prepare(sqlite3* db, const std::string& sql)
+{
+  sqlite3_stmt* stmt = nullptr;
+  fl::api(sqlite3_prepare_v2,
+          { SQLITE_OK },
+          db,
+          db,
+          sql.c_str(),
+          -1,
+          &stmt,
+          nullptr);
+  return stmt;
+}
+
+// Virtual table through `fl::vtab::base`.
+
+class bench_series : public fl::vtab::base<bench_series>
+{
+public:
+  static inline char const* const name = "bench_series";
+  static inline bool const eponymous = true;
+
+  using result_type = std::vector<std::array<fl::value::variant, 2>>;
+
+  struct cursor
+  {
+    cursor(bench_series* vtab) {}
+  };
+
+  void xConnect(bool create)
+  {
+    declare(R"SQL(
+      CREATE TABLE bench_series(
+        n INT VT_REQUIRED HIDDEN NOT NULL,
+        value INT
+      )
+    )SQL");
+  }
+
+  result_type xFilter(const fl::vtab::index_info& info, cursor* cursor)
+  {
+    auto n = fl::value::as<int64_t>(
+      info.get("n", SQLITE_INDEX_CONSTRAINT_EQ)->current_raw);
+
+    result_type result;
+    result.reserve(n);
+
+    for (int64_t ix = 0; ix < n; ++ix) {
+      result.push_back({ fl::value::integer{ n }, fl::value::integer{ ix } });
+    }
+
+    return result;
+  }
+};
+
+// The same virtual table against the C API.
+
+struct raw_series_cursor
+{
+  sqlite3_vtab_cursor base;
+  int64_t n;
+  int64_t value;
+};
+
+int
+raw_series_connect(sqlite3* db,
+                   void*,
+                   int,
+                   const char* const*,
+                   sqlite3_vtab** vtab,
+                   char**)
+{
+  int rc = sqlite3_declare_vtab(
+    db, "CREATE TABLE x(n INT HIDDEN NOT NULL, value INT)");
+
+  if (SQLITE_OK != rc) {
+    return rc;
+  }
+
+  *vtab = static_cast<sqlite3_vtab*>(sqlite3_malloc(sizeof(sqlite3_vtab)));
+  std::memset(*vtab, 0, sizeof(sqlite3_vtab));
+  return SQLITE_OK;
+}
+
+int
+raw_series_best_index(sqlite3_vtab*, sqlite3_index_info* info)
+{
+  for (int ix = 0; ix < info->nConstraint; ++ix) {
+    auto& c = info->aConstraint[ix];
+    if (c.iColumn == 0 && c.op == SQLITE_INDEX_CONSTRAINT_EQ && c.usable) {
+      info->aConstraintUsage[ix].argvIndex = 1;
+      info->aConstraintUsage[ix].omit = 1;
+      info->estimatedCost = 1;
+      return SQLITE_OK;
+    }
+  }
+
+  return SQLITE_CONSTRAINT;
+}
+
+sqlite3_module
+make_raw_series_module()
+{
+  sqlite3_module m{};
+
+  m.iVersion = 0;
+  m.xConnect = raw_series_connect;
+  m.xBestIndex = raw_series_best_index;
+  m.xDisconnect = [](sqlite3_vtab* vtab) {
+    sqlite3_free(vtab);
+    return SQLITE_OK;
+  };
+  m.xOpen = [](sqlite3_vtab*, sqlite3_vtab_cursor** cursor) {
+    auto c =
+      static_cast<raw_series_cursor*>(sqlite3_malloc(sizeof(raw_series_cursor)));
+    std::memset(c, 0, sizeof(raw_series_cursor));
+    *cursor = &c->base;
+    return SQLITE_OK;
+  };
+  m.xClose = [](sqlite3_vtab_cursor* cursor) {
+    sqlite3_free(cursor);
+    return SQLITE_OK;
+  };
+  m.xFilter = [](sqlite3_vtab_cursor* cursor,
+                 int,
+                 const char*,
+                 int argc,
+                 sqlite3_value** argv) {
+    auto c = reinterpret_cast<raw_series_cursor*>(cursor);
+    c->n = sqlite3_value_int64(argv[0]);
+    c->value = 0;
+    return SQLITE_OK;
+  };
+  m.xNext = [](sqlite3_vtab_cursor* cursor) {
+    reinterpret_cast<raw_series_cursor*>(cursor)->value++;
+    return SQLITE_OK;
+  };
+  m.xEof = [](sqlite3_vtab_cursor* cursor) {
+    auto c = reinterpret_cast<raw_series_cursor*>(cursor);
+    return int(c->value >= c->n);
+  };
+  m.xColumn = [](sqlite3_vtab_cursor* cursor, sqlite3_context* ctx, int id) {
+    auto c = reinterpret_cast<raw_series_cursor*>(cursor);
+    sqlite3_result_int64(ctx, id == 0 ? c->n : c->value);
+    return SQLITE_OK;
+  };
+  m.xRowid = [](sqlite3_vtab_cursor* cursor, sqlite3_int64* rowid) {
+    *rowid = reinterpret_cast<raw_series_cursor*>(cursor)->value;
+    return SQLITE_OK;
+  };
+
+  return m;
+}
+
+sqlite3_module const raw_series_module = make_raw_series_module();
+
+// Functions through `fl::fx::base` and against the C API.
+
+class bench_add : public fl::fx::base<bench_add>
+{
+public:
+  static constexpr auto name = "bench_add";
+  static constexpr auto deterministic = true;
+  static constexpr auto direct_only = false;
+
+  int64_t xFunc(int64_t value) { return value + 1; }
+};
+
+class bench_sum : public fl::fx::base<bench_sum>
+{
+public:
+  static constexpr auto name = "bench_sum";
+  static constexpr auto deterministic = true;
+  static constexpr auto direct_only = false;
+
+  void xStep(int64_t value) { accumulator += value; }
+  int64_t xFinal() { return accumulator; }
+
+protected:
+  int64_t accumulator = 0;
+};
+
+void
+raw_add(sqlite3_context* ctx, int, sqlite3_value** argv)
+{
+  sqlite3_result_int64(ctx, sqlite3_value_int64(argv[0]) + 1);
+}
+
+void
+raw_sum_step(sqlite3_context* ctx, int, sqlite3_value** argv)
+{
+  auto sum = static_cast<int64_t*>(
+    sqlite3_aggregate_context(ctx, sizeof(int64_t)));
+  *sum += sqlite3_value_int64(argv[0]);
+}
+
+void
+raw_sum_final(sqlite3_context* ctx)
+{
+  auto sum = static_cast<int64_t*>(sqlite3_aggregate_context(ctx, 0));
+  sqlite3_result_int64(ctx, sum ? *sum : 0);
+}
+
+int64_t
+raw_scalar(sqlite3* db, const std::string& sql)
+{
+  auto stmt = raw_prepare(db, sql);
+  sqlite3_step(stmt);
+  auto result = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+  return result;
+}
+
+int64_t
+fl_scalar(fl::db& db, const std::string& sql)
+{
+  auto stmt = db.prepare(sql);
+  stmt.execute();
+  return stmt.current_row().at(0).to_integer();
+}
+
+struct record
+{
+  int64_t i;
+  double r;
+  std::string t;
+};
+
+int
+main(int argc, char** argv)
+{
+  int64_t n = 200000;
+
+  if (argc > 1) {
+    size_t end = 0;
+
+    try {
+      n = std::stoll(argv[1], &end);
+    } catch (const std::exception&) {
+      n = 0;
+    }
+
+    if (n < 1 || '\0' != argv[1][end] || argc > 2) {
+      std::cerr << "usage: " << argv[0] << " [scale]" << std::endl
+                << "  scale: number of operations per case, at least 1"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  auto db = fl::db(":memory:");
+  auto raw = db.ptr().get();
+
+  db.prepare(R"SQL(
+
+    CREATE TABLE data AS
+    WITH RECURSIVE
+    base(value) AS (
+      SELECT 1 UNION ALL SELECT value + 1 FROM base WHERE value < ?1
+    )
+    SELECT value AS i, value * 0.5 AS r, 'v' || value AS t FROM base
+
+  )SQL")
+    .execute(n);
+
+  bench_series::register_module(db);
+  db.register_module("raw_series", &raw_series_module);
+
+  bench_add::register_function(db);
+  bench_sum::register_function(db);
+
+  fl::api(sqlite3_create_function_v2,
+          { SQLITE_OK },
+          raw,
+          raw,
+          "raw_add",
+          1,
+          SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+          nullptr,
+          raw_add,
+          nullptr,
+          nullptr,
+          nullptr);
+
+  fl::api(sqlite3_create_function_v2,
+          { SQLITE_OK },
+          raw,
+          raw,
+          "raw_sum",
+          1,
+          SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+          nullptr,
+          nullptr,
+          raw_sum_step,
+          raw_sum_final,
+          nullptr);
+
+  // bind
+
+  {
+    auto stmt = db.prepare("SELECT ?1");
+    auto p = stmt.ptr().get();
+    std::string text = "some text value";
+    fl::blob_type blob(16, std::byte{ 0x2a });
+
+    measure("bind_integer", "federlieb", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        stmt.bind(1, ix);
+      }
+      return n;
+    });
+
+    measure("bind_integer", "raw", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        sqlite3_bind_int64(p, 1, ix);
+      }
+      return n;
+    });
+
+    measure("bind_real", "federlieb", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        stmt.bind(1, ix * 0.5);
+      }
+      return n;
+    });
+
+    measure("bind_real", "raw", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        sqlite3_bind_double(p, 1, ix * 0.5);
+      }
+      return n;
+    });
+
+    measure("bind_text", "federlieb", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        stmt.bind(1, text);
+      }
+      return n;
+    });
+
+    measure("bind_text", "raw", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        sqlite3_bind_text64(
+          p, 1, text.data(), text.size(), SQLITE_TRANSIENT, SQLITE_UTF8);
+      }
+      return n;
+    });
+
+    measure("bind_blob", "federlieb", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        stmt.bind(1, blob);
+      }
+      return n;
+    });
+
+    measure("bind_blob", "raw", n, [&] {
+      for (int64_t ix = 0; ix < n; ++ix) {
+        sqlite3_bind_blob64(p, 1, blob.data(), blob.size(), SQLITE_TRANSIENT);
+      }
+      return n;
+    });
+  }
+
+  // step
+
+  measure("step", "federlieb", n, [&] {
+    auto stmt = db.prepare("SELECT i FROM data");
+    stmt.execute();
+    int64_t count = 0;
+    for (auto&& row : stmt) {
+      count += row.size();
+    }
+    return count;
+  });
+
+  measure("step", "raw", n, [&] {
+    auto stmt = raw_prepare(raw, "SELECT i FROM data");
+    int64_t count = 0;
+    while (SQLITE_ROW == sqlite3_step(stmt)) {
+      count += sqlite3_column_count(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return count;
+  });
+
+  // as<T>
+
+  measure("as", "federlieb", n, [&] {
+    auto stmt = db.prepare("SELECT i, r, t FROM data");
+    stmt.execute();
+    int64_t checksum = 0;
+    for (auto&& e : stmt | fl::as<record>()) {
+      checksum += e.i + int64_t(e.r) + e.t.size();
+    }
+    return checksum;
+  });
+
+  measure("as", "raw", n, [&] {
+    auto stmt = raw_prepare(raw, "SELECT i, r, t FROM data");
+    int64_t checksum = 0;
+    while (SQLITE_ROW == sqlite3_step(stmt)) {
+      record e;
+      e.i = sqlite3_column_int64(stmt, 0);
+      e.r = sqlite3_column_double(stmt, 1);
+      e.t.assign((const char*)sqlite3_column_text(stmt, 2),
+                 sqlite3_column_bytes(stmt, 2));
+      checksum += e.i + int64_t(e.r) + e.t.size();
+    }
+    sqlite3_finalize(stmt);
+    return checksum;
+  });
+
+  // to_variant
+
+  measure("to_variant", "federlieb", 3 * n, [&] {
+    auto stmt = db.prepare("SELECT i, r, t FROM data");
+    stmt.execute();
+    int64_t checksum = 0;
+    for (auto&& row : stmt) {
+      for (auto&& field : row) {
+        checksum += field.to_variant().index();
+      }
+    }
+    return checksum;
+  });
+
+  measure("to_variant", "raw", 3 * n, [&] {
+    auto stmt = raw_prepare(raw, "SELECT i, r, t FROM data");
+    int64_t checksum = 0;
+    while (SQLITE_ROW == sqlite3_step(stmt)) {
+      for (int ix = 0; ix < 3; ++ix) {
+        fl::value::variant v;
+        switch (sqlite3_column_type(stmt, ix)) {
+          case SQLITE_INTEGER:
+            v = fl::value::integer{ sqlite3_column_int64(stmt, ix) };
+            break;
+          case SQLITE_FLOAT:
+            v = fl::value::real{ sqlite3_column_double(stmt, ix) };
+            break;
+          case SQLITE_TEXT:
+            v = fl::value::text{ std::string(
+              (const char*)sqlite3_column_text(stmt, ix),
+              sqlite3_column_bytes(stmt, ix)) };
+            break;
+          default:
+            v = fl::value::null{};
+        }
+        checksum += v.index();
+      }
+    }
+    sqlite3_finalize(stmt);
+    return checksum;
+  });
+
+  // vtab: xBestIndex, once per prepare of a new statement
+
+  int64_t const plans = std::max<int64_t>(1, n / 100);
+
+  measure("vtab_best_index", "federlieb", plans, [&] {
+    for (int64_t ix = 0; ix < plans; ++ix) {
+      sqlite3_finalize(raw_prepare(
+        raw,
+        "SELECT value FROM bench_series(" + std::to_string(ix) +
+          ") WHERE value > " + std::to_string(ix)));
+    }
+    return plans;
+  });
+
+  measure("vtab_best_index", "raw", plans, [&] {
+    for (int64_t ix = 0; ix < plans; ++ix) {
+      sqlite3_finalize(raw_prepare(
+        raw,
+        "SELECT value FROM raw_series(" + std::to_string(ix) +
+          ") WHERE value > " + std::to_string(ix)));
+    }
+    return plans;
+  });
+
+  // vtab: xFilter, xNext and xColumn for every row
+
+  auto series_sql = [](char const* const table) {
+    return fl::detail::format("SELECT sum(value) FROM {}(?1)", table);
+  };
+
+  measure("vtab_scan", "federlieb", n, [&] {
+    auto stmt = db.prepare(series_sql("bench_series"));
+    stmt.execute(n);
+    return stmt.current_row().at(0).to_integer();
+  });
+
+  measure("vtab_scan", "raw", n, [&] {
+    auto stmt = raw_prepare(raw, series_sql("raw_series"));
+    sqlite3_bind_int64(stmt, 1, n);
+    sqlite3_step(stmt);
+    auto result = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return result;
+  });
+
+  // fx
+
+  measure("fx_scalar", "federlieb", n, [&] {
+    return fl_scalar(db, "SELECT sum(bench_add(i)) FROM data");
+  });
+
+  measure("fx_scalar", "raw", n, [&] {
+    return raw_scalar(raw, "SELECT sum(raw_add(i)) FROM data");
+  });
+
+  measure("fx_aggregate", "federlieb", n, [&] {
+    return fl_scalar(db, "SELECT bench_sum(i) FROM data");
+  });
+
+  measure("fx_aggregate", "raw", n, [&] {
+    return raw_scalar(raw, "SELECT raw_sum(i) FROM data");
+  });
+
+  return 0;
+}
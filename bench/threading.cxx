@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+// Steps through a generated table and reads every column, calling the
+// SQLite API through `fl::api` with each threading policy. Connections
+// are opened with the mutex mode the policy would pick in `fl::db::open`.
+// Prints one line per policy in `key=value` form.
+
+template<fl::threading Policy>
+void
+run(char const* const name, int const open_flags, int64_t const rows)
+{
+  auto db = fl::db(":memory:",
+                   SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | open_flags);
+
+  db.prepare(R"SQL(
+
+    CREATE TABLE data AS
+    WITH RECURSIVE
+    base(value) AS (
+      SELECT 1 UNION ALL SELECT value + 1 FROM base WHERE value < ?1
+    )
+    SELECT value AS i, value * 0.5 AS r, 'v' || value AS t FROM base
+
+  )SQL")
+    .execute(rows);
+
+  auto stmt = db.prepare("SELECT i, r, t FROM data");
+  auto raw = stmt.ptr().get();
+  auto handle = db.ptr().get();
+
+  int64_t checksum = 0;
+  int64_t count = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  fl::api<Policy>(sqlite3_reset, { SQLITE_OK }, handle, raw);
+
+  while (SQLITE_ROW == fl::api<Policy>(sqlite3_step,
+                                       { SQLITE_ROW, SQLITE_DONE },
+                                       handle,
+                                       raw)) {
+    checksum += fl::api(sqlite3_column_int64, handle, raw, 0);
+    checksum += int64_t(fl::api(sqlite3_column_double, handle, raw, 1));
+    checksum += fl::api(sqlite3_column_bytes, handle, raw, 2);
+    count++;
+  }
+
+  auto elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  std::cout << "bench=threading"
+            << " policy=" << name << " rows=" << count
+            << " seconds=" << elapsed
+            << " rows_per_second=" << int64_t(count / elapsed)
+            << " checksum=" << checksum << '\n';
+}
+
+int
+main(int argc, char** argv)
+{
+  int64_t rows = argc > 1 ? std::stoll(argv[1]) : 1000000;
+
+  run<fl::threading::single_thread>("single_thread", SQLITE_OPEN_NOMUTEX, rows);
+  run<fl::threading::serialized_by_sqlite>(
+    "serialized_by_sqlite", SQLITE_OPEN_FULLMUTEX, rows);
+  run<fl::threading::explicit_lock>(
+    "explicit_lock", SQLITE_OPEN_FULLMUTEX, rows);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+// Compares `fl::io_uring_vfs` with the default VFS on a database file in
+// the directory given as the first argument (default: the current one),
+// which should be on a local disk. The optional second argument scales
+// the number of operations. Every case prints one line in `key=value`
+// form,
+//
+//   bench=<case> vfs=<name> ops=<n> seconds=<s> ns_per_op=<ns>
+//   checksum=<c>
+//
+// followed by the counters of the io_uring VFS.
+
+struct bench_db
+{
+  std::filesystem::path path;
+  fl::db db;
+
+  bench_db(const std::filesystem::path& dir,
+           const std::string& vfs,
+           const std::string& synchronous)
+    : path(dir / "federlieb_bench_vfs.db")
+  {
+    remove();
+
+    db = fl::db(path.string(), SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, vfs);
+
+    db.execute_script(R"SQL(
+      PRAGMA journal_mode = WAL;
+      CREATE TABLE data(id INTEGER PRIMARY KEY, payload BLOB NOT NULL);
+    )SQL");
+
+    db.prepare("PRAGMA synchronous = " + synchronous).execute();
+  }
+
+  ~bench_db()
+  {
+    db = fl::db();
+    remove();
+  }
+
+  void remove()
+  {
+    for (auto&& suffix : { "", "-wal", "-shm", "-journal" }) {
+      std::filesystem::remove(path.string() + suffix);
+    }
+  }
+};
+
+template<typename F>
+void
+measure(char const* const name,
+        const std::string& vfs,
+        int64_t const ops,
+        F&& f)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  int64_t checksum = f();
+
+  auto elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  std::cout << "bench=" << name << " vfs=" << (vfs.empty() ? "default" : vfs)
+            << " ops=" << ops << " seconds=" << elapsed
+            << " ns_per_op=" << (ops ? elapsed * 1e9 / ops : 0)
+            << " checksum=" << checksum << '\n';
+}
+
+// Many small transactions, the case bound by system calls.
+void
+bench_commits(const std::filesystem::path& dir,
+              const std::string& vfs,
+              const std::string& synchronous,
+              int64_t const n)
+{
+  bench_db b(dir, vfs, synchronous);
+
+  auto insert = b.db.prepare("INSERT INTO data(payload) VALUES(zeroblob(?1))");
+
+  measure(("commits_" + synchronous).c_str(), vfs, n, [&] {
+    for (int64_t ix = 0; ix < n; ++ix) {
+      insert.execute(int64_t(200 + ix % 300));
+    }
+    return b.db.select_scalar<int64_t>("SELECT sum(length(payload)) FROM data");
+  });
+}
+
+void
+bench_bulk_and_scan(const std::filesystem::path& dir,
+                    const std::string& vfs,
+                    int64_t const n)
+{
+  bench_db b(dir, vfs, "NORMAL");
+
+  auto insert = b.db.prepare("INSERT INTO data(payload) VALUES(randomblob(?1))");
+
+  measure("bulk_insert", vfs, n, [&] {
+    b.db.prepare("BEGIN").execute();
+    for (int64_t ix = 0; ix < n; ++ix) {
+      insert.execute(int64_t(1000));
+    }
+    b.db.prepare("COMMIT").execute();
+    return n;
+  });
+
+  b.db.prepare("PRAGMA wal_checkpoint(TRUNCATE)").execute();
+
+  // NOTE: a small page cache, so the scan has to read from the file.
+  b.db.prepare("PRAGMA cache_size = 16").execute();
+
+  measure("scan", vfs, n, [&] {
+    return b.db.select_scalar<int64_t>(
+      "SELECT sum(length(payload)) FROM data WHERE payload IS NOT NULL");
+  });
+}
+
+int
+main(int argc, char* argv[])
+{
+  std::filesystem::path dir = argc > 1 ? argv[1] : ".";
+  int64_t scale = argc > 2 ? std::stoll(argv[2]) : 1;
+
+  fl::io_uring_vfs::register_vfs();
+
+  for (auto&& vfs : { std::string(), std::string(fl::io_uring_vfs::name) }) {
+    bench_commits(dir, vfs, "NORMAL", 2000 * scale);
+    bench_commits(dir, vfs, "FULL", 500 * scale);
+    bench_bulk_and_scan(dir, vfs, 20000 * scale);
+  }
+
+  auto stats = fl::io_uring_vfs::stats();
+
+  std::cout << "vfs=" << fl::io_uring_vfs::name << " submits=" << stats.submits
+            << " reads=" << stats.reads << " writes=" << stats.writes
+            << " syncs=" << stats.syncs
+            << " batched_writes=" << stats.batched_writes
+            << " readahead_hits=" << stats.readahead_hits << '\n';
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "federlieb/federlieb.hxx"
+
+#include "fx_counter.hxx"
+#include "fx_kcrypto.hxx"
+#include "fx_ordered_concat_agg.hxx"
+#include "fx_toset.hxx"
+
+#include "vt_contraction.hxx"
+#include "vt_dijkstra_shortest_paths.hxx"
+#include "vt_dominator_tree.hxx"
+#include "vt_nameless.hxx"
+#include "vt_partition_by.hxx"
+#include "vt_stmt.hxx"
+#include "vt_strong_components.hxx"
+#include "vt_transitive_closure.hxx"
+#include "vt_weak_components.hxx"
+
+#include "vt_import.hxx"
+#include "vt_json_each.hxx"
+#include "vt_kv.hxx"
+#include "vt_script.hxx"
+#include "vt_stmt_stats.hxx"
+
+namespace fl = ::federlieb;
+
+// Registers all modules and functions of the extension with `db`. Also
+// suitable as `fl::db_pool` setup function.
+inline void
+register_extensions(fl::db& db)
+{
+  vt_dominator_tree::register_module(db);
+  vt_stmt::register_module(db);
+  vt_partition_by::register_module(db);
+  vt_strong_components::register_module(db);
+  vt_weak_components::register_module(db);
+  vt_transitive_closure::register_module(db);
+  vt_nameless::register_module(db);
+  vt_contraction::register_module(db);
+  vt_dijkstra_shortest_paths::register_module(db);
+  vt_json_each::register_module(db);
+  vt_script::register_module(db);
+  vt_stmt_stats::register_module(db);
+  vt_import::register_module(db);
+  vt_kv::register_module(db);
+
+  fx_toset::register_function(db);
+  fx_toset_agg::register_function(db);
+  fx_toset_union::register_function(db);
+  fx_toset_intersection::register_function(db);
+  fx_toset_except::register_function(db);
+  fx_toset_contains::register_function(db);
+  fx_object_set_agg::register_function(db);
+
+  fx_sha1::register_function(db);
+
+  fx_counter::register_function(db);
+
+  fx_ordered_concat_agg::register_function(db);
+}
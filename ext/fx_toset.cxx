@@ -13,9 +13,9 @@ fx_toset::xFunc(const fl::value::variant& value)
 }
 
 void
-fx_toset_agg::xStep(const fl::value::variant value)
+fx_toset_agg::xStep(const fl::value::view value)
 {
-  if (std::holds_alternative<fl::value::blob>(value)) {
+  if (std::holds_alternative<fl::value::blob_view>(value)) {
     fl::error::raise("Cannot turn BLOB into JSON");
   }
   data_.insert(data_.end(), boost::json::value_from(value));
@@ -23,7 +23,7 @@ public:
   static inline auto const deterministic = true;
   static inline auto const direct_only = false;
 
-  void xStep(const fl::value::variant value);
+  void xStep(const fl::value::view value);
   boost::json::array xFinal();
 
 protected:
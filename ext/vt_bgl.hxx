@@ -36,7 +36,8 @@ struct variant_graph
 
   // This used to use boost::bimap, until hitting cases where insert
   // and lookup returned buggy results for unknown reasons.
-  std::map<fl::value::variant, vertex_type> variant_to_vertex_;
+  // NOTE: `std::less<>` allows lookups by `fl::value::view`.
+  std::map<fl::value::variant, vertex_type, std::less<>> variant_to_vertex_;
   std::map<vertex_type, fl::value::variant> vertex_to_variant_;
 
   fl::value::variant variant(const T::vertex_descriptor& vertex) const
@@ -44,6 +45,13 @@ struct variant_graph
     return vertex_to_variant_.at(vertex);
   }
 
+  // Valid as long as the graph, for `fl::vtab::columns` results.
+  fl::value::variant const* variant_ptr(
+    const T::vertex_descriptor& vertex) const
+  {
+    return &vertex_to_variant_.at(vertex);
+  }
+
   vertex_type operator[](const fl::value::variant& variant)
   {
 
@@ -56,23 +64,43 @@ struct variant_graph
     return variant_to_vertex_.at(variant);
   }
 
+  // Like the above, but only copies `view` for vertices not seen before.
+  vertex_type operator[](const fl::value::view& view)
+  {
+    auto it = variant_to_vertex_.find(view);
+
+    if (it != variant_to_vertex_.end()) {
+      return it->second;
+    }
+
+    return operator[](fl::value::from(view));
+  }
+
   vertex_type vertex(const fl::value::variant& variant)
   {
     return operator[](variant);
   }
 
+  vertex_type vertex(const fl::value::view& view) { return operator[](view); }
+
   auto edge(const fl::value::variant& src, const fl::value::variant& dst)
   {
     return boost::add_edge(
       this->operator[](src), this->operator[](dst), graph_);
   }
 
+  auto edge(const fl::value::view& src, const fl::value::view& dst)
+  {
+    return boost::add_edge(
+      this->operator[](src), this->operator[](dst), graph_);
+  }
+
   void import(fl::stmt& vertices_stmt, fl::stmt& edges_stmt)
   {
     vertices_stmt.reset().execute();
 
     for (auto row : vertices_stmt) {
-      auto v = vertex(row.at(0).to_variant());
+      auto v = vertex(row.at(0).to_view());
       for (auto prop : row | std::views::drop(1)) {
         graph_[v].insert_or_assign(prop.name(), prop.to_variant());
       }
@@ -83,7 +111,7 @@ struct variant_graph
     edges_stmt.reset().execute();
 
     for (auto row : edges_stmt) {
-      auto e = edge(row.at(0), row.at(1));
+      auto e = edge(row.at(0).to_view(), row.at(1).to_view());
 
       for (auto prop : row | std::views::drop(2)) {
         graph_[e.first].insert_or_assign(prop.name(), prop.to_variant());
@@ -107,6 +135,7 @@ struct variant_graph
   fl::stmt to_component_stmt(std::vector<size_t> component) const
   {
     fl::db tmp(":memory:");
+    fl::pragma::apply(tmp, fl::pragma::profile("in-memory-scratch"));
 
     tmp.execute_script(R"SQL(
 
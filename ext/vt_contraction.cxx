@@ -56,7 +56,7 @@ vt_contraction::cursor::import_edges(vt_contraction* vtab)
 
   edges_stmt.execute();
 
-  insert_edge_stmt.executemany(edges_stmt);
+  insert_edge_stmt.executemany(edges_stmt, {});
 
   tmpdb_.execute_script(R"SQL(
 
@@ -232,6 +232,7 @@ vt_contraction::cursor::contract_edges(vt_contraction* vtab)
 vt_contraction::cursor::cursor(vt_contraction* vtab)
   : tmpdb_(":memory:")
 {
+  fl::pragma::apply(tmpdb_, fl::pragma::profile("in-memory-scratch"));
   import_edges(vtab);
   contract_vertices(vtab);
   contract_edges(vtab);
@@ -25,13 +25,88 @@ vt_dijkstra_shortest_paths::xConnect(bool create)
     )");
 }
 
+namespace {
+
+// Calls `f` with each vertex when its distance is final, in order of
+// distance.
+template<typename F>
+struct on_examine_vertex
+{
+  using event_filter = boost::on_examine_vertex;
+
+  F f;
+
+  template<typename Vertex, typename Graph>
+  void operator()(Vertex v, const Graph&)
+  {
+    f(v);
+  }
+};
+
+struct stop_search
+{};
+
+bool
+is_distance_bound(int const op)
+{
+  switch (op) {
+    case SQLITE_INDEX_CONSTRAINT_EQ:
+    case SQLITE_INDEX_CONSTRAINT_GT:
+    case SQLITE_INDEX_CONSTRAINT_GE:
+    case SQLITE_INDEX_CONSTRAINT_LT:
+    case SQLITE_INDEX_CONSTRAINT_LE:
+    case SQLITE_INDEX_CONSTRAINT_ISNOTNULL:
+      return true;
+  }
+
+  return false;
+}
+
+}
+
+bool
+vt_dijkstra_shortest_paths::xBestIndex(fl::vtab::index_info& info)
+{
+  info.mark_in_lists("source");
+
+  // Bounds on the distance are applied during the search, which stops at
+  // the upper bound. They exclude unreachable vertices, with NULL as
+  // distance, so rows can then come in order of distance.
+  bool bounded = false;
+
+  for (auto&& column : info.columns) {
+    if (column.column_name == "distance") {
+      for (auto&& constraint : column.constraints) {
+        if (constraint.usable && is_distance_bound(constraint.op)) {
+          constraint.argv_index = info.next_argv_index++;
+          bounded = true;
+        }
+      }
+    }
+  }
+
+  auto source = info.get("source", SQLITE_INDEX_CONSTRAINT_EQ);
+
+  auto ordered_by_distance = std::ranges::all_of(info.columns, [](auto&& e) {
+    return !e.order_by_pos ||
+           (e.column_name == "distance" && !e.order_by_desc.value_or(false));
+  });
+
+  if (bounded && ordered_by_distance && source &&
+      !source->many_at_once.value_or(false)) {
+    info.order_by_consumed = true;
+  }
+
+  info.mark_limit();
+
+  return true;
+}
+
 vt_dijkstra_shortest_paths::result_type
 vt_dijkstra_shortest_paths::xFilter(const fl::vtab::index_info& info,
                                     cursor* cursor)
 {
 
-  auto source =
-    info.get("source", SQLITE_INDEX_CONSTRAINT_EQ)->current_value.value();
   auto weights = info.get("column", SQLITE_INDEX_CONSTRAINT_EQ);
 
   std::string weight_column_name =
@@ -45,8 +120,80 @@ vt_dijkstra_shortest_paths::xFilter(const fl::vtab::index_info& info,
   using vertex_descriptor = graph_type::vertex_descriptor;
   using edge_descriptor = graph_type::edge_descriptor;
 
-  std::vector<vertex_descriptor> predecessors(boost::num_vertices(g));
-  std::vector<double> distances(boost::num_vertices(g));
+  // NOTE: with `source IN (...)` all sources are served by this call, the
+  // weights are read once and the runs share the buffers below. Sources
+  // not in the graph are added as vertices, so this comes first.
+  auto sources = std::make_shared<std::vector<vertex_descriptor>>();
+
+  for (auto&& source :
+       info.get("source", SQLITE_INDEX_CONSTRAINT_EQ)->current_values()) {
+    sources->push_back(cursor->g_.vertex(source));
+  }
+
+  // Bounds on the distance, see xBestIndex; non-numeric ones are left to
+  // SQLite.
+  bool bounded = false;
+  std::vector<std::pair<int, double>> bounds;
+
+  for (auto&& column : info.columns) {
+    if (column.column_name == "distance") {
+      for (auto&& constraint : column.constraints) {
+        if (!constraint.argv_index) {
+          continue;
+        }
+
+        bounded = true;
+
+        auto type = sqlite3_value_numeric_type(constraint.current_raw);
+
+        if (SQLITE_INTEGER == type || SQLITE_FLOAT == type) {
+          bounds.push_back(
+            { constraint.op, sqlite3_value_double(constraint.current_raw) });
+        }
+      }
+    }
+  }
+
+  auto accepts = [&bounds](double const d) {
+    return std::ranges::all_of(bounds, [d](auto&& e) {
+      switch (e.first) {
+        case SQLITE_INDEX_CONSTRAINT_EQ:
+          return d == e.second;
+        case SQLITE_INDEX_CONSTRAINT_GT:
+          return d > e.second;
+        case SQLITE_INDEX_CONSTRAINT_GE:
+          return d >= e.second;
+        case SQLITE_INDEX_CONSTRAINT_LT:
+          return d < e.second;
+        case SQLITE_INDEX_CONSTRAINT_LE:
+          return d <= e.second;
+      }
+      return true;
+    });
+  };
+
+  // NOTE: distances only grow during a search.
+  auto beyond = [&bounds](double const d) {
+    return std::ranges::any_of(bounds, [d](auto&& e) {
+      switch (e.first) {
+        case SQLITE_INDEX_CONSTRAINT_EQ:
+        case SQLITE_INDEX_CONSTRAINT_LE:
+          return d > e.second;
+        case SQLITE_INDEX_CONSTRAINT_LT:
+          return d >= e.second;
+      }
+      return false;
+    });
+  };
+
+  auto wanted = info.rows_wanted();
+
+  auto n = boost::num_vertices(g);
+
+  // NOTE: shared with the computed columns of the result, `n` entries for
+  // each source.
+  auto predecessors = std::make_shared<std::vector<vertex_descriptor>>();
+  auto distances = std::make_shared<std::vector<double>>(n * sources->size());
   std::map<edge_descriptor, double> weight_map;
 
   for (auto&& e : boost::make_iterator_range(boost::edges(g))) {
@@ -55,35 +202,119 @@ vt_dijkstra_shortest_paths::xFilter(const fl::vtab::index_info& info,
   }
 
   auto weight_pmap = boost::make_assoc_property_map(weight_map);
-  auto distance_pmap = boost::make_iterator_property_map(
-    distances.begin(), boost::get(boost::vertex_index, g));
-  auto predecessor_pmap = boost::make_iterator_property_map(
-    predecessors.begin(), boost::get(boost::vertex_index, g));
-
-  boost::dijkstra_shortest_paths(
-    g,
-    cursor->g_.vertex(source),
-    predecessor_pmap,
-    distance_pmap,
-    weight_pmap,
-    boost::get(boost::vertex_index, g),
-    std::less<double>(),
-    boost::closed_plus<double>(),
-    std::numeric_limits<double>::infinity(),
-    0,
-    boost::dijkstra_visitor<boost::null_visitor>());
-
-  result_type result;
-
-  for (auto v : boost::make_iterator_range(boost::vertices(g))) {
-    result.push_back({ source,
-                       fl::value::from(weight_column_name),
-                       cursor->g_.variant(v),
-                       cursor->g_.variant(predecessors[v]),
-                       std::isinf(distances[v])
-                         ? fl::value::null{}
-                         : fl::value::from(distances[v]) });
+
+  // With bounds or a limit, only the vertices the searches reached, in
+  // order of distance for each source, as `source * n + vertex`.
+  std::shared_ptr<std::vector<size_t>> picked;
+
+  if (bounded || wanted) {
+    picked = std::make_shared<std::vector<size_t>>();
+  }
+
+  auto run = [&](size_t const ix, auto&& predecessor_pmap) {
+    auto examine = [&](vertex_descriptor v) {
+      auto d = (*distances)[ix * n + v];
+
+      if (beyond(d)) {
+        throw stop_search{};
+      }
+
+      if (accepts(d)) {
+        picked->push_back(ix * n + v);
+      }
+
+      if (wanted && picked->size() >= size_t(*wanted)) {
+        throw stop_search{};
+      }
+    };
+
+    auto search = [&](auto&& visitor) {
+      boost::dijkstra_shortest_paths(
+        g,
+        (*sources)[ix],
+        predecessor_pmap,
+        boost::make_iterator_property_map(distances->begin() + ix * n,
+                                          boost::get(boost::vertex_index, g)),
+        weight_pmap,
+        boost::get(boost::vertex_index, g),
+        std::less<double>(),
+        boost::closed_plus<double>(),
+        std::numeric_limits<double>::infinity(),
+        0,
+        visitor);
+    };
+
+    if (!picked) {
+      search(boost::dijkstra_visitor<boost::null_visitor>());
+      return;
+    }
+
+    try {
+      search(boost::make_dijkstra_visitor(
+        on_examine_vertex<decltype(examine)>{ examine }));
+    } catch (const stop_search&) {
+      return;
+    }
+
+    // NOTE: without bounds unreachable vertices are rows too, with NULL
+    // as distance.
+    for (size_t v = 0; !bounded && v < n; ++v) {
+      if (wanted && picked->size() >= size_t(*wanted)) {
+        break;
+      }
+      if (std::isinf((*distances)[ix * n + v])) {
+        picked->push_back(ix * n + v);
+      }
+    }
+  };
+
+  bool const with_predecessors = info.used("predecessor");
+
+  if (with_predecessors) {
+    predecessors->resize(n * sources->size());
   }
 
-  return result;
+  for (size_t ix = 0; ix < sources->size(); ++ix) {
+    if (wanted && picked->size() >= size_t(*wanted)) {
+      break;
+    }
+
+    if (with_predecessors) {
+      run(ix,
+          boost::make_iterator_property_map(
+            predecessors->begin() + ix * n,
+            boost::get(boost::vertex_index, g)));
+    } else {
+      run(ix, boost::dummy_property_map());
+    }
+  }
+
+  // NOTE: row `r` is `source * n + vertex` for the searches that ran to
+  // the end, vertices are numbered from zero and point into the cursor's
+  // graph; the column is stored once.
+  auto graph = &cursor->g_;
+  auto rows = picked ? picked->size() : n * sources->size();
+
+  auto flat = [picked](size_t r) { return picked ? (*picked)[r] : r; };
+
+  return result_type(
+    { rows,
+      [graph, sources, n, flat](size_t r) {
+        return graph->variant_ptr((*sources)[flat(r) / n]);
+      } },
+    { weight_column_name },
+    { rows,
+      [graph, n, flat](size_t r) { return graph->variant_ptr(flat(r) % n); } },
+    { rows,
+      [graph, predecessors, flat](size_t r) -> fl::value::variant const* {
+        // NOTE: only filled in when SQLite said it uses the column.
+        if (predecessors->empty()) {
+          return nullptr;
+        }
+        return graph->variant_ptr((*predecessors)[flat(r)]);
+      } },
+    { rows, [distances, flat](size_t r) {
+       auto d = (*distances)[flat(r)];
+       return std::isinf(d) ? std::nullopt : std::make_optional(d);
+     } });
 }
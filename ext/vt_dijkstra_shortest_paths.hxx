@@ -12,7 +12,12 @@ class vt_dijkstra_shortest_paths
 public:
   static inline char const* const name = "fl_dijkstra_shortest_paths";
 
-  using result_type = std::list<std::array<fl::value::variant, 5>>;
+  using result_type =
+    fl::vtab::columns<fl::vtab::computed<fl::value::variant const*>,
+                      fl::vtab::constant<std::string>,
+                      fl::vtab::computed<fl::value::variant const*>,
+                      fl::vtab::computed<fl::value::variant const*>,
+                      fl::vtab::computed<std::optional<double>>>;
 
   struct cursor
   {
@@ -21,6 +26,7 @@ public:
   };
 
   void xConnect(bool create);
+  bool xBestIndex(fl::vtab::index_info& info);
 
   result_type xFilter(const fl::vtab::index_info& info, cursor* cursor);
 };
@@ -27,50 +27,66 @@ vt_dominator_tree::xConnect(bool create)
     )");
 }
 
+bool
+vt_dominator_tree::xBestIndex(fl::vtab::index_info& info)
+{
+  info.mark_in_lists("root");
+  return true;
+}
+
 vt_dominator_tree::result_type
 vt_dominator_tree::xFilter(const fl::vtab::index_info& info, cursor* cursor)
 {
 
-  auto& root = info.columns[1].constraints[0].current_value;
-
   using vertex_descriptor = decltype(cursor->g_.graph_)::vertex_descriptor;
 
-  std::map<vertex_descriptor, vertex_descriptor> dom_map;
-  auto dom_pm = boost::associative_property_map(dom_map);
+  result_type result({}, {}, {});
+
+  // NOTE: with `root IN (...)` all roots are served by this call.
+  for (auto&& root : info.columns[1].constraints[0].current_values()) {
 
-  Directed copy;
-  boost::copy_graph(cursor->g_.graph_, copy);
+    // NOTE: before copying, this adds roots not in the graph.
+    auto root_vertex = cursor->g_[root];
 
-  std::vector<size_t> seen(boost::num_vertices(copy));
+    std::map<vertex_descriptor, vertex_descriptor> dom_map;
+    auto dom_pm = boost::associative_property_map(dom_map);
 
-  auto seen_map = boost::make_iterator_property_map(
-      seen.begin(), boost::get(boost::vertex_index, copy));
+    Directed copy;
+    boost::copy_graph(cursor->g_.graph_, copy);
 
-  std::vector<boost::default_color_type> color(boost::num_vertices(copy));
-  auto color_map = boost::make_iterator_property_map(color.begin(),
-                                                     boost::get(boost::vertex_index, copy));
+    std::vector<size_t> seen(boost::num_vertices(copy));
 
-  size_t t = 0;
+    auto seen_map = boost::make_iterator_property_map(
+        seen.begin(), boost::get(boost::vertex_index, copy));
 
-  boost::depth_first_visit(copy, cursor->g_[*root],
-                           boost::make_dfs_visitor(
-                               boost::stamp_times(seen_map, t, boost::on_discover_vertex())),
-                           color_map);
+    std::vector<boost::default_color_type> color(boost::num_vertices(copy));
+    auto color_map = boost::make_iterator_property_map(color.begin(),
+                                                       boost::get(boost::vertex_index, copy));
 
-  for (size_t ix = 0; ix < seen.size(); ++ix) {
-    if (!seen[ix]) {
-      // std::cout << "clearing vertex " << ix << std::endl;
-      boost::clear_vertex(ix, copy);
+    size_t t = 0;
+
+    boost::depth_first_visit(copy, root_vertex,
+                             boost::make_dfs_visitor(
+                                 boost::stamp_times(seen_map, t, boost::on_discover_vertex())),
+                             color_map);
+
+    for (size_t ix = 0; ix < seen.size(); ++ix) {
+      if (!seen[ix]) {
+        // std::cout << "clearing vertex " << ix << std::endl;
+        boost::clear_vertex(ix, copy);
+      }
     }
-  }
 
-  lengauer_tarjan_dominator_tree(copy, cursor->g_[*root], dom_pm);
+    lengauer_tarjan_dominator_tree(copy, root_vertex, dom_pm);
 
-  result_type result;
+    // NOTE: the root as stored in the cursor's graph, like the vertices.
+    auto root_ptr = cursor->g_.variant_ptr(root_vertex);
 
-  for (auto e : dom_map) {
-    result.push_back(
-      { *root, cursor->g_.variant(e.first), cursor->g_.variant(e.second) });
+    for (auto e : dom_map) {
+      result.get<0>().push_back(root_ptr);
+      result.get<1>().push_back(cursor->g_.variant_ptr(e.first));
+      result.get<2>().push_back(cursor->g_.variant_ptr(e.second));
+    }
   }
 
   return result;
@@ -11,7 +11,10 @@ class vt_dominator_tree : public fl::vtab::base<vt_dominator_tree>
 public:
   static inline char const* const name = "fl_dominator_tree";
 
-  using result_type = std::list<std::array<fl::value::variant, 3>>;
+  using result_type =
+    fl::vtab::columns<std::vector<fl::value::variant const*>,
+                      std::vector<fl::value::variant const*>,
+                      std::vector<fl::value::variant const*>>;
 
   struct cursor
   {
@@ -20,6 +23,7 @@ public:
   };
 
   void xConnect(bool create);
+  bool xBestIndex(fl::vtab::index_info& info);
 
   result_type xFilter(const fl::vtab::index_info& info, cursor* cursor);
 };
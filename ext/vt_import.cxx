@@ -0,0 +1,623 @@
+#include "vt_import.hxx"
+#include "federlieb/federlieb.hxx"
+
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace fl = ::federlieb;
+
+namespace {
+
+class mapped_file
+{
+public:
+  explicit mapped_file(const std::string& path)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    fl::error::raise_if(fd < 0, "cannot open file");
+
+    struct stat st;
+
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      fl::error::raise("cannot stat file");
+    }
+
+    size_ = size_t(st.st_size);
+
+    // NOTE: mapping zero bytes fails.
+    if (size_ > 0) {
+      void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (MAP_FAILED == p) {
+        ::close(fd);
+        fl::error::raise("cannot map file");
+      }
+
+      ::madvise(p, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<char const*>(p);
+    }
+
+    ::close(fd);
+  }
+
+  ~mapped_file()
+  {
+    if (nullptr != data_) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  std::string_view data() const { return { data_, size_ }; }
+
+protected:
+  char const* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// First of `a`, `b`, or `c` in [p, end), or `end`.
+char const*
+find_any(char const* p, char const* const end, char a, char b, char c)
+{
+#if defined(__SSE2__)
+  auto va = _mm_set1_epi8(a);
+  auto vb = _mm_set1_epi8(b);
+  auto vc = _mm_set1_epi8(c);
+
+  for (; end - p >= 16; p += 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    auto m = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+      _mm_cmpeq_epi8(v, vc));
+
+    if (auto mask = unsigned(_mm_movemask_epi8(m))) {
+      return p + std::countr_zero(mask);
+    }
+  }
+#endif
+
+  for (; p < end; ++p) {
+    if (*p == a || *p == b || *p == c) {
+      return p;
+    }
+  }
+
+  return end;
+}
+
+size_t
+count_quotes(char const* p, char const* const end)
+{
+  size_t result = 0;
+
+#if defined(__SSE2__)
+  auto vq = _mm_set1_epi8('"');
+
+  for (; end - p >= 16; p += 16) {
+    auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    result += std::popcount(
+      unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vq))));
+  }
+#endif
+
+  for (; p < end; ++p) {
+    result += ('"' == *p);
+  }
+
+  return result;
+}
+
+// Offset just past the first record separator at or after `target`,
+// where `start` is the beginning of a record. Quotes only matter for CSV:
+// an odd number of them between `start` and `target` means `target` is
+// inside a quoted field. JSON cannot have raw newlines in strings.
+size_t
+next_boundary(std::string_view const data,
+              size_t const start,
+              size_t const target,
+              vt_import::format const format)
+{
+  auto const begin = data.data();
+  auto const end = begin + data.size();
+  auto p = begin + std::min(target, data.size());
+
+  bool quoted = vt_import::format::csv == format &&
+                count_quotes(begin + start, p) % 2 == 1;
+
+  for (;;) {
+    p = vt_import::format::csv == format ? find_any(p, end, '"', '\n', '\n')
+                                         : find_any(p, end, '\n', '\n', '\n');
+
+    if (p == end) {
+      return data.size();
+    }
+
+    if ('"' == *p) {
+      quoted = !quoted;
+    } else if (!quoted) {
+      return size_t(p - begin) + 1;
+    }
+
+    ++p;
+  }
+}
+
+// Appends the records in `data`, which has to start and end at record
+// boundaries. Rows are resized to `width` unless that is zero. Blank
+// lines are skipped.
+void
+parse_csv(std::string_view const data,
+          char const delimiter,
+          size_t const width,
+          std::vector<vt_import::row>& out)
+{
+  auto p = data.data();
+  auto const end = p + data.size();
+
+  while (p < end) {
+    if ('\n' == *p || ('\r' == *p && p + 1 < end && '\n' == p[1])) {
+      p += ('\r' == *p) ? 2 : 1;
+      continue;
+    }
+
+    vt_import::row row;
+    row.reserve(width);
+
+    for (;;) {
+      std::string field;
+
+      if (p < end && '"' == *p) {
+        ++p;
+
+        for (;;) {
+          auto q = std::find(p, end, '"');
+          fl::error::raise_if(q == end, "unterminated quoted field");
+          field.append(p, q);
+          p = q + 1;
+
+          if (p < end && '"' == *p) {
+            field.push_back('"');
+            ++p;
+          } else {
+            break;
+          }
+        }
+
+        // NOTE: text between the closing quote and the delimiter is kept.
+        auto e = find_any(p, end, delimiter, '\n', '\n');
+        field.append(p, e);
+        p = e;
+      } else {
+        auto e = find_any(p, end, delimiter, '\n', '\n');
+        field.assign(p, e);
+        p = e;
+      }
+
+      if (p == end || '\n' == *p) {
+        if (!field.empty() && '\r' == field.back()) {
+          field.pop_back();
+        }
+      }
+
+      row.push_back(fl::value::text{ std::move(field) });
+
+      if (p < end && delimiter == *p) {
+        ++p;
+        continue;
+      }
+
+      if (p < end) {
+        ++p;
+      }
+
+      break;
+    }
+
+    if (width > 0) {
+      row.resize(width, fl::value::null{});
+    }
+
+    out.push_back(std::move(row));
+  }
+}
+
+fl::value::variant
+from_json(const boost::json::value& value)
+{
+  switch (value.kind()) {
+    case boost::json::kind::bool_:
+      return fl::value::integer{ value.get_bool() };
+    case boost::json::kind::array:
+    case boost::json::kind::object:
+      return fl::value::json{ boost::json::serialize(value) };
+    default:
+      return boost::json::value_to<fl::value::variant>(value);
+  }
+}
+
+void
+parse_jsonl(std::string_view const data,
+            const std::vector<std::string>& columns,
+            std::vector<vt_import::row>& out)
+{
+  auto p = data.data();
+  auto const end = p + data.size();
+
+  while (p < end) {
+    auto e = std::find(p, end, '\n');
+    auto line = std::string_view(p, e);
+    p = (e == end) ? end : e + 1;
+
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+      continue;
+    }
+
+    if (columns.empty()) {
+      out.push_back({ fl::value::json{ std::string(line) } });
+      continue;
+    }
+
+    auto value = boost::json::parse(line);
+    auto object = value.if_object();
+
+    vt_import::row row;
+    row.reserve(columns.size());
+
+    for (auto&& column : columns) {
+      auto field = object ? object->if_contains(column) : nullptr;
+      row.push_back(field ? from_json(*field) : fl::value::null{});
+    }
+
+    out.push_back(std::move(row));
+  }
+}
+
+std::string
+dequote(std::string s)
+{
+  if (s.size() >= 2 && (s.front() == '\'' || s.front() == '"') &&
+      s.front() == s.back()) {
+    return s.substr(1, s.size() - 2);
+  }
+
+  return s;
+}
+
+std::vector<std::string>
+split_columns(std::string s)
+{
+  if (s.size() >= 2 && s.front() == '(' && s.back() == ')') {
+    s = s.substr(1, s.size() - 2);
+  }
+
+  std::vector<std::string> result;
+
+  for (auto&& part : fl::detail::regex_split(s, std::regex(R"(\s*,\s*)"), -1)) {
+    auto trimmed = dequote(std::regex_replace(
+      std::string(part), std::regex(R"(^\s+|\s+$)"), ""));
+
+    if (!trimmed.empty()) {
+      result.push_back(trimmed);
+    }
+  }
+
+  return result;
+}
+
+}
+
+class vt_import::importer
+{
+public:
+  importer(const vt_import::options& options, size_t const width)
+    : options_(options)
+    , width_(width)
+    , file_(options.path)
+    , window_(2 * options.threads)
+  {
+    auto data = file_.data();
+
+    if (vt_import::format::csv == options_.format && options_.header) {
+      offset_ = next_boundary(data, 0, 0, options_.format);
+    }
+
+    threads_.reserve(options_.threads);
+
+    for (size_t ix = 0; ix < options_.threads; ++ix) {
+      threads_.emplace_back([this] { work(); });
+    }
+  }
+
+  ~importer()
+  {
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+    }
+
+    room_.notify_all();
+
+    for (auto&& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  importer(const importer&) = delete;
+  importer& operator=(const importer&) = delete;
+
+  const vt_import::row& current() const { return current_[ix_]; }
+  bool done() const { return done_; }
+
+  // Moves to the next row, waiting for its chunk to be parsed if needed.
+  void advance()
+  {
+    if (ix_ + 1 < current_.size()) {
+      ++ix_;
+      return;
+    }
+
+    std::unique_lock lock(mutex_);
+
+    for (;;) {
+      ready_.wait(lock, [this] {
+        return error_ || parsed_.contains(consumed_) || exhausted();
+      });
+
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+
+      auto it = parsed_.find(consumed_);
+
+      if (it == parsed_.end()) {
+        current_.clear();
+        ix_ = 0;
+        done_ = true;
+        return;
+      }
+
+      current_ = std::move(it->second);
+      parsed_.erase(it);
+      consumed_++;
+      ix_ = 0;
+
+      room_.notify_all();
+
+      // NOTE: a chunk of blank lines has no rows.
+      if (!current_.empty()) {
+        return;
+      }
+    }
+  }
+
+protected:
+  // All chunks handed out and consumed.
+  bool exhausted() const
+  {
+    return offset_ >= file_.data().size() && consumed_ == assigned_;
+  }
+
+  void work()
+  {
+    auto data = file_.data();
+
+    for (;;) {
+      std::unique_lock lock(mutex_);
+
+      room_.wait(lock, [&] {
+        return stopping_ || error_ || offset_ >= data.size() ||
+               assigned_ < consumed_ + window_;
+      });
+
+      if (stopping_ || error_ || offset_ >= data.size()) {
+        return;
+      }
+
+      // NOTE: finding the boundary is a quote count and a short scan,
+      // parsing happens without the lock.
+      auto seq = assigned_++;
+      auto start = offset_;
+      std::vector<vt_import::row> rows;
+
+      try {
+        offset_ = next_boundary(
+          data, start, start + options_.chunk_size, options_.format);
+
+        auto chunk = data.substr(start, offset_ - start);
+
+        lock.unlock();
+
+        if (vt_import::format::csv == options_.format) {
+          parse_csv(chunk, options_.delimiter, width_, rows);
+        } else {
+          parse_jsonl(chunk, options_.columns, rows);
+        }
+
+        lock.lock();
+      } catch (...) {
+        if (!lock.owns_lock()) {
+          lock.lock();
+        }
+
+        error_ = std::current_exception();
+        ready_.notify_all();
+        room_.notify_all();
+        return;
+      }
+
+      parsed_.emplace(seq, std::move(rows));
+      ready_.notify_all();
+    }
+  }
+
+  vt_import::options options_;
+  size_t width_;
+  mapped_file file_;
+  size_t window_;
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable room_;
+
+  // Start of the next chunk to hand out, chunks handed out and consumed.
+  size_t offset_ = 0;
+  size_t assigned_ = 0;
+  size_t consumed_ = 0;
+  std::map<size_t, std::vector<vt_import::row>> parsed_;
+  std::exception_ptr error_;
+  bool stopping_ = false;
+
+  // Only used by the reading thread.
+  std::vector<vt_import::row> current_;
+  size_t ix_ = 0;
+  bool done_ = false;
+
+  // NOTE: Declared last so everything above exists when the threads start.
+  std::vector<std::thread> threads_;
+};
+
+const vt_import::row&
+vt_import::rows::iterator::operator*() const
+{
+  return importer_->current();
+}
+
+vt_import::rows::iterator&
+vt_import::rows::iterator::operator++()
+{
+  importer_->advance();
+  return *this;
+}
+
+bool
+vt_import::rows::iterator::operator==(std::default_sentinel_t) const
+{
+  return nullptr == importer_ || importer_->done();
+}
+
+vt_import::rows::iterator
+vt_import::rows::begin()
+{
+  if (importer_) {
+    importer_->advance();
+  }
+
+  return iterator(importer_.get());
+}
+
+void
+vt_import::xConnect(bool create)
+{
+  options_.path = dequote(kwarg_or_throw("path"));
+
+  auto format = kwarg("format");
+
+  if (format) {
+    fl::error::raise_if(*format != "csv" && *format != "jsonl",
+                        "format must be csv or jsonl");
+    options_.format = ("csv" == *format) ? format::csv : format::jsonl;
+  } else if (options_.path.ends_with(".jsonl") ||
+             options_.path.ends_with(".ndjson")) {
+    options_.format = format::jsonl;
+  }
+
+  if (auto columns = kwarg("columns")) {
+    options_.columns = split_columns(*columns);
+    fl::error::raise_if(options_.columns.empty(), "no columns");
+  }
+
+  options_.header = kwarg("header").value_or("1") != "0";
+
+  if (auto delimiter = kwarg("delimiter")) {
+    auto d = dequote(*delimiter);
+
+    if ("tab" == d) {
+      options_.delimiter = '\t';
+    } else {
+      fl::error::raise_if(d.size() != 1, "delimiter must be one character");
+      options_.delimiter = d.front();
+    }
+  }
+
+  options_.threads = std::max(1u, std::thread::hardware_concurrency());
+
+  if (auto threads = kwarg("threads")) {
+    options_.threads = std::stoull(*threads);
+    fl::error::raise_if(options_.threads < 1, "threads must be > 0");
+  }
+
+  if (auto chunk_size = kwarg("chunk_size")) {
+    options_.chunk_size = std::stoull(*chunk_size);
+    fl::error::raise_if(options_.chunk_size < 1, "chunk_size must be > 0");
+  }
+
+  mapped_file file(options_.path);
+  auto data = file.data();
+  file_size_ = data.size();
+
+  std::vector<std::string> names = options_.columns;
+
+  if (names.empty() && format::jsonl == options_.format) {
+    names = { "value" };
+  }
+
+  // The first record names or counts the columns.
+  if (names.empty()) {
+    std::vector<vt_import::row> first;
+    parse_csv(data.substr(0, next_boundary(data, 0, 0, options_.format)),
+              options_.delimiter,
+              0,
+              first);
+
+    fl::error::raise_if(first.empty(), "cannot determine columns");
+
+    for (size_t ix = 0; ix < first.front().size(); ++ix) {
+      names.push_back(
+        options_.header
+          ? std::get<fl::value::text>(first.front()[ix]).value
+          : "c" + std::to_string(1 + ix));
+    }
+  }
+
+  std::string sql = "CREATE TABLE fl_import(";
+
+  for (size_t ix = 0; ix < names.size(); ++ix) {
+    sql += (ix ? ", " : "") + fl::detail::quote_identifier(names[ix]) + " ANY";
+  }
+
+  declare(sql + ")");
+}
+
+bool
+vt_import::xBestIndex(fl::vtab::index_info& info)
+{
+  // NOTE: a rough guess, a full scan is the only plan.
+  info.estimated_rows = std::max<long long>(1, file_size_ / 64);
+  info.estimated_cost = double(info.estimated_rows);
+
+  return true;
+}
+
+vt_import::result_type
+vt_import::xFilter(const fl::vtab::index_info& info, cursor* cursor)
+{
+  auto width = columns_.size() - 1;
+  return rows(std::make_shared<importer>(options_, width));
+}
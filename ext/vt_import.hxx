@@ -0,0 +1,113 @@
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "federlieb/vtab.hxx"
+
+namespace fl = ::federlieb;
+
+/*
+
+CREATE VIRTUAL TABLE t USING fl_import(
+  path=data.csv
+, format=csv | jsonl
+, header=1
+, columns=(a, b, c)
+, delimiter=tab
+, threads=8
+, chunk_size=4194304
+)
+
+*/
+
+// Reads a CSV or JSON lines file. The file is memory-mapped and split into
+// chunks at record boundaries, the chunks are parsed on a pool of threads
+// started for each scan, and rows are handed to SQLite in file order.
+// At most two chunks per thread are parsed ahead of the reader.
+//
+// CSV follows RFC 4180, fields are TEXT and missing ones NULL. Without a
+// header the columns are `c1`, `c2`, ... unless named with `columns`.
+//
+// JSON lines produce one column `value` with each line as JSON, or with
+// `columns` the values of those keys of each line's object.
+class vt_import : public fl::vtab::base<vt_import>
+{
+public:
+  static inline char const* const name = "fl_import";
+  static inline bool const eponymous = false;
+
+  enum class format
+  {
+    csv,
+    jsonl
+  };
+
+  struct options
+  {
+    std::string path;
+    vt_import::format format = format::csv;
+    bool header = true;
+    char delimiter = ',';
+    std::vector<std::string> columns;
+    size_t threads = 1;
+    size_t chunk_size = 4 << 20;
+  };
+
+  using row = std::vector<fl::value::variant>;
+
+  class importer;
+
+  // Single pass, like a statement.
+  class rows
+  {
+  public:
+    class iterator
+    {
+    public:
+      using value_type = row;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() = default;
+      explicit iterator(importer* importer)
+        : importer_(importer)
+      {}
+
+      const row& operator*() const;
+      iterator& operator++();
+      void operator++(int) { ++*this; }
+      bool operator==(std::default_sentinel_t) const;
+
+    protected:
+      importer* importer_ = nullptr;
+    };
+
+    rows() = default;
+    explicit rows(std::shared_ptr<importer> importer)
+      : importer_(std::move(importer))
+    {}
+
+    iterator begin();
+    std::default_sentinel_t end() const { return {}; }
+
+  protected:
+    std::shared_ptr<importer> importer_;
+  };
+
+  using result_type = rows;
+
+  struct cursor
+  {
+    cursor(vt_import* vtab) {}
+  };
+
+  void xConnect(bool create);
+  bool xBestIndex(fl::vtab::index_info& info);
+  result_type xFilter(const fl::vtab::index_info& info, cursor* cursor);
+
+protected:
+  options options_;
+  size_t file_size_ = 0;
+};
@@ -26,6 +26,8 @@ vt_json_each::xBestIndex(fl::vtab::index_info& info)
     info.estimated_rows = 25;
   }
 
+  info.mark_limit();
+
   return true;
 }
 
@@ -33,8 +35,8 @@ vt_json_each::result_type
 vt_json_each::xFilter(const fl::vtab::index_info& info, cursor* cursor)
 {
 
-  auto source_variant =
-    info.get("json", SQLITE_INDEX_CONSTRAINT_EQ)->current_value.value();
+  auto source_view =
+    info.get("json", SQLITE_INDEX_CONSTRAINT_EQ)->current_view.value();
 
   // FIXME: also accept dicts?
 
@@ -42,32 +44,50 @@ vt_json_each::xFilter(const fl::vtab::index_info& info, cursor* cursor)
 
   // TODO: cleanup
 
-  if (std::holds_alternative<fl::value::text>(source_variant)) {
-    array = boost::json::parse(std::get<fl::value::text>(source_variant).value).as_array();
+  if (std::holds_alternative<fl::value::text_view>(source_view)) {
+    array = boost::json::parse(std::get<fl::value::text_view>(source_view).value).as_array();
 #if 0
-  } else if (std::holds_alternative<fl::value::blob>(source_variant)) {
+  } else if (std::holds_alternative<fl::value::blob_view>(source_view)) {
     std::string source;
-    auto blob = std::get<fl::value::blob>(source_variant).value;
+    auto blob = std::get<fl::value::blob_view>(source_view).value;
     std::copy(blob.begin(), blob.end(), source);
     array = boost::json::parse(source).as_array();
 #endif
-  } else if (std::holds_alternative<fl::value::json>(source_variant)) {
-    array = boost::json::parse(std::get<fl::value::json>(source_variant).value).as_array();
+  } else if (std::holds_alternative<fl::value::json_view>(source_view)) {
+    array = boost::json::parse(std::get<fl::value::json_view>(source_view).value).as_array();
   } else {
     fl::error::raise("bad source");
   }
 
-  vt_json_each::result_type result;
-  for (auto&& e : array) {
+  // Parsed without copying, copied once for the hidden column.
+  auto source_variant =
+    std::make_shared<const fl::value::variant>(fl::value::from(source_view));
 
-    // TODO: avoid copying source_variant if not requested?
-    result.push_back({
-        source_variant,
-        boost::json::value_to<fl::value::variant>(e)
-    });
+  auto elements = std::make_shared<boost::json::array>(std::move(array));
 
+  size_t rows = elements->size();
+
+  if (auto wanted = info.rows_wanted()) {
+    rows = std::min(rows, size_t(*wanted));
   }
 
-  return result;
+  return result_type([source_variant, elements, rows, ix = size_t(0)]() mutable
+                       -> std::optional<row> {
+    if (ix >= rows) {
+      return std::nullopt;
+    }
+
+    return row{ source_variant,
+                boost::json::value_to<fl::value::variant>((*elements)[ix++]) };
+  });
+}
 
+void
+vt_json_each::row::result(fl::context& context, int const column) const
+{
+  if (0 == column) {
+    context.result(*json);
+  } else {
+    context.result(value);
+  }
 }
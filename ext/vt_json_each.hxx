@@ -13,7 +13,18 @@ public:
   static inline char const* const name = "fl_json_each";
   static inline bool const eponymous = true;
 
-  using result_type = std::list<std::array<fl::value::variant, 2>>;
+  // Rows share the source, SQLite gets a copy only when it asks for the
+  // hidden column.
+  struct row
+  {
+    std::shared_ptr<const fl::value::variant> json;
+    fl::value::variant value;
+
+    void result(fl::context& context, int const column) const;
+  };
+
+  // Elements are converted as xNext gets to them.
+  using result_type = fl::vtab::generator<row>;
 
   struct cursor
   {
@@ -0,0 +1,96 @@
+#include "federlieb/federlieb.hxx"
+#include "vt_kv.hxx"
+
+#include <set>
+
+namespace fl = ::federlieb;
+
+void
+vt_kv::xConnect(bool create)
+{
+  declare(R"SQL(
+    CREATE TABLE fl_kv(
+      key NOT NULL,
+      value
+    )
+  )SQL");
+}
+
+bool
+vt_kv::apply(std::map<sqlite3_int64, row>& rows,
+             const fl::vtab::change& change)
+{
+  if (change.old_rowid) {
+    rows.erase(*change.old_rowid);
+  }
+
+  if (change.op == fl::vtab::change::operation::remove) {
+    return true;
+  }
+
+  return rows
+    .try_emplace(
+      *change.new_rowid,
+      row{ change.values.at(0), change.values.at(1), *change.new_rowid })
+    .second;
+}
+
+vt_kv::result_type
+vt_kv::xFilter(const fl::vtab::index_info& info, cursor* cursor)
+{
+  // Changes of the current transaction on top of the committed rows, so
+  // statements in the transaction see them.
+  auto rows = rows_;
+
+  for (auto&& change : changes_) {
+    apply(rows, change);
+  }
+
+  result_type result;
+  result.reserve(rows.size());
+
+  for (auto&& [id, row] : rows) {
+    result.push_back(row);
+  }
+
+  return result;
+}
+
+void
+vt_kv::xUpdate(fl::vtab::change& change)
+{
+  using operation = fl::vtab::change::operation;
+
+  if (change.op == operation::remove) {
+    return;
+  }
+
+  fl::error::raise_if(
+    std::holds_alternative<fl::value::null>(change.values.at(0)),
+    "fl_kv: key is NULL");
+
+  if (!change.new_rowid) {
+    change.new_rowid = next_rowid_;
+  }
+
+  next_rowid_ = std::max(next_rowid_, *change.new_rowid + 1);
+}
+
+void
+vt_kv::xSync(std::vector<fl::vtab::change>& batch)
+{
+  // Applied to a copy so a failed commit leaves the table as it was.
+  auto rows = rows_;
+
+  for (auto&& change : batch) {
+    fl::error::raise_if(!apply(rows, change), "fl_kv: duplicate rowid");
+  }
+
+  std::set<fl::value::variant> keys;
+
+  for (auto&& [id, row] : rows) {
+    fl::error::raise_if(!keys.insert(row.key).second, "fl_kv: duplicate key");
+  }
+
+  rows_ = std::move(rows);
+}
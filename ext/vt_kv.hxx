@@ -0,0 +1,48 @@
+#pragma once
+
+#include <map>
+
+#include "federlieb/vtab.hxx"
+
+namespace fl = ::federlieb;
+
+// In-memory table of `key` and `value` pairs, for scratch data that
+// should take part in transactions. A NULL key rejects the statement.
+// Keys must also be unique, which is checked when SQLite commits, as
+// the changes of a transaction are kept aside until then; a duplicate
+// fails the commit and rolls the transaction back.
+class vt_kv : public fl::vtab::base<vt_kv>
+{
+public:
+  static inline char const* const name = "fl_kv";
+
+  struct row
+  {
+    fl::value::variant key;
+    fl::value::variant value;
+    sqlite3_int64 id;
+
+    sqlite3_int64 rowid() const { return id; }
+  };
+
+  using result_type = std::vector<row>;
+
+  struct cursor
+  {
+    cursor(vt_kv* vtab) {}
+  };
+
+  void xConnect(bool create);
+  result_type xFilter(const fl::vtab::index_info& info, cursor* cursor);
+  void xUpdate(fl::vtab::change& change);
+  void xSync(std::vector<fl::vtab::change>& batch);
+
+protected:
+  // Applies `change` to `rows`, false when it would replace another row.
+  static bool apply(std::map<sqlite3_int64, row>& rows,
+                    const fl::vtab::change& change);
+
+  // Committed rows by rowid.
+  std::map<sqlite3_int64, row> rows_;
+  sqlite3_int64 next_rowid_ = 1;
+};
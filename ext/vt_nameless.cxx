@@ -55,7 +55,7 @@ vt_nameless::xFilter(const fl::vtab::index_info& info, cursor* cursor)
 {
 
   auto source_variant =
-    info.get("source", SQLITE_INDEX_CONSTRAINT_EQ)->current_value.value();
+    info.get("source", SQLITE_INDEX_CONSTRAINT_EQ)->current_value().value();
 
   fl::error::raise_if(!std::holds_alternative<fl::value::text>(source_variant),
                       "bad source");
@@ -118,7 +118,7 @@ vt_nameless::xFilter(const fl::vtab::index_info& info, cursor* cursor)
   for (auto p : params_) {
     auto constraint = info.get(p, SQLITE_INDEX_CONSTRAINT_EQ);
     if (constraint) {
-      stmt.bind(":" + p, constraint->current_value.value());
+      stmt.bind(":" + p, constraint->current_view.value());
     }
   }
 
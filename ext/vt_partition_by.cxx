@@ -23,6 +23,7 @@ vt_partition_by::xConnect(bool create)
 vt_partition_by::cursor::cursor(vt_partition_by* vtab)
   : tmpdb_(":memory:")
 {
+  fl::pragma::apply(tmpdb_, fl::pragma::profile("in-memory-scratch"));
 
   tmpdb_.execute_script(R"SQL(
 
@@ -92,7 +93,7 @@ vt_partition_by::subquery(const fl::vtab::index_info& info,
   auto sub_stmt = cursor->tmpdb_.prepare(sub_sql);
 
   if (element_eq) {
-    sub_stmt.bind(":element", element_eq->current_value.value());
+    sub_stmt.bind(":element", element_eq->current_view.value());
   }
 
   sub_stmt.execute();
@@ -140,29 +141,41 @@ vt_partition_by::project(const std::string& sql,
                          vt_partition_by::cursor* cursor)
 {
 
-  // TODO: ought to be cached for then_bys
+  // The statement reads this table, so it must not live in the table's
+  // statement cache, that would keep the table from being disconnected.
+  // Kept with the cursor instead, then_bys run it again every round.
+  auto found = cursor->projections_.find(sql);
 
-  auto projection_stmt = db().prepare(fl::detail::format(
-    R"SQL(
+  if (cursor->projections_.end() == found) {
 
-      WITH
-      {} AS MATERIALIZED (
-        SELECT
-          element, current
-        FROM
-          {}.{}
-        WHERE
-          (cursor_ptr IS :cursor_ptr)
-      )
-      SELECT * FROM {}
+    auto projection_sql = fl::detail::format(
+      R"SQL(
+
+        WITH
+        {} AS MATERIALIZED (
+          SELECT
+            element, current
+          FROM
+            {}.{}
+          WHERE
+            (cursor_ptr IS :cursor_ptr)
+        )
+        SELECT * FROM {}
+
+      )SQL",
+      fl::detail::quote_identifier(table_name_),
+      fl::detail::quote_identifier(schema_name_),
+      fl::detail::quote_identifier(table_name_),
+      sql);
+
+    auto uncached = fl::db(db().ptr());
+    found =
+      cursor->projections_.emplace(sql, uncached.prepare(projection_sql)).first;
+  }
 
-    )SQL",
-    fl::detail::quote_identifier(table_name_),
-    fl::detail::quote_identifier(schema_name_),
-    fl::detail::quote_identifier(table_name_),
-    sql));
+  auto& projection_stmt = found->second;
 
-  projection_stmt.bind_pointer(
+  projection_stmt.reset().bind_pointer(
     ":cursor_ptr", "partition_by:cursor_ptr", static_cast<void*>(cursor));
 
   projection_stmt.execute();
@@ -171,7 +184,7 @@ vt_partition_by::project(const std::string& sql,
 
   cursor->tmpdb_
     .prepare("INSERT INTO signature(element, signature) VALUES(?1, ?2)")
-    .executemany(projection_stmt);
+    .executemany(projection_stmt, {});
 
   refine(cursor);
 }
@@ -232,14 +245,14 @@ vt_partition_by::apply_then_bys(vt_partition_by::cursor* cursor)
                           }));
 
   while (true) {
-    auto before = cursor->tmpdb_.select_scalar(
+    auto before = cursor->tmpdb_.select_scalar<int64_t>(
       "SELECT COUNT(DISTINCT representative) FROM tracking");
 
     for (auto&& current : then_bys) {
       project(current.second, cursor);
     }
 
-    auto after = cursor->tmpdb_.select_scalar(
+    auto after = cursor->tmpdb_.select_scalar<int64_t>(
       "SELECT COUNT(DISTINCT representative) FROM tracking");
 
     if (after <= before) {
@@ -341,7 +354,7 @@ vt_partition_by::xFilter(const fl::vtab::index_info& info, cursor* cursor)
   cursor
     ->tmpdb_ //
     .prepare("INSERT INTO tracking(element) VALUES(?1)")
-    .executemany(elements_stmt);
+    .executemany(elements_stmt, {});
 
   apply_once_bys(cursor);
   apply_then_bys(cursor);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include "federlieb/vtab.hxx"
 
 namespace fl = ::federlieb;
@@ -16,6 +18,8 @@ public:
   {
     fl::db tmpdb_;
     size_t round_ = 1;
+    // Projection statements by user-supplied SQL, see `project`.
+    std::map<std::string, fl::stmt> projections_;
 
     cursor(vt_partition_by* vtab);
   };
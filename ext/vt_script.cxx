@@ -40,8 +40,13 @@ void unparenthesize(std::string& s) {
 fl::stmt
 vt_script::xFilter(const fl::vtab::index_info& info, cursor* cursor)
 {
-  auto script = arguments().front();
-  unparenthesize(script);
-  db().execute_script(script);
+  if (!script_) {
+    auto script = arguments().front();
+    unparenthesize(script);
+    script_.emplace(db(), script);
+  }
+
+  script_->execute();
+
   return db().prepare("SELECT 1").execute();
 }
@@ -17,4 +17,9 @@ public:
 
   void xConnect(bool create);
   fl::stmt xFilter(const fl::vtab::index_info& info, cursor* cursor);
+
+protected:
+  // Prepared on first use and then kept, so that running the script again
+  // does not prepare it again.
+  std::optional<fl::script> script_;
 };
@@ -5,9 +5,12 @@
 
 namespace fl = ::federlieb;
 
+// NOTE: the virtual table has the `parameters` of the statement first, the
+// `data` table only the columns of the statement.
 std::string
 to_where_fragment(const std::string& table_name,
-                                              const fl::vtab::index_info& info)
+                  const fl::vtab::index_info& info,
+                  int const parameters)
 {
   std::stringstream ss;
 
@@ -15,7 +18,7 @@ to_where_fragment(const std::string& table_name,
 
   for (auto column : info.columns) {
     auto quoted_column_name = fl::detail::quote_identifier(
-      "c" + std::to_string(1 + column.column_index));
+      "c" + std::to_string(1 + column.column_index - parameters));
 
     for (auto constraint : column.constraints) {
 
@@ -25,7 +28,7 @@ to_where_fragment(const std::string& table_name,
 
       auto constraint_string = to_sql(constraint);
 
-      if (!constraint_string.empty() && column.column_index >= 0) {
+      if (!constraint_string.empty() && column.column_index >= parameters) {
         if (ss.tellp() > 0) {
           ss << " AND ";
         }
@@ -39,7 +42,9 @@ to_where_fragment(const std::string& table_name,
 }
 
 std::string
-to_create_index(const std::string& table_name, const fl::vtab::index_info& info)
+to_create_index(const std::string& table_name,
+                const fl::vtab::index_info& info,
+                int const parameters)
 {
   std::stringstream ss;
 
@@ -49,7 +54,7 @@ to_create_index(const std::string& table_name, const fl::vtab::index_info& info)
 
   for (auto column : info.columns) {
     auto quoted_column_name = fl::detail::quote_identifier(
-      "c" + std::to_string(1 + column.column_index));
+      "c" + std::to_string(1 + column.column_index - parameters));
 
     for (auto constraint : column.constraints) {
 
@@ -57,7 +62,7 @@ to_create_index(const std::string& table_name, const fl::vtab::index_info& info)
         continue;
       }
 
-      if (column.column_index < 0) {
+      if (column.column_index < parameters) {
         continue;
       }
 
@@ -92,9 +97,8 @@ vt_stmt::cache::change_meta_refcount(int64_t const id, int64_t const diff)
 
 vt_stmt::cursor::cursor(vt_stmt* vtab)
 {
-  auto key_sql = vtab->kwarg("key").value_or("(SELECT RANDOMBLOB(16))");
-
-  key_ = vtab->db().select_scalar(key_sql);
+  // Prepared once, the table's `db()` has a statement cache.
+  key_ = vtab->db().select_scalar<fl::value::variant>(vtab->key_sql_);
 }
 
 auto
@@ -102,6 +106,7 @@ vt_stmt::init_cache(fl::stmt& stmt)
 {
 
   auto db = fl::db(":memory:");
+  fl::pragma::apply(db, fl::pragma::profile("in-memory-scratch"));
 
   fl::error::raise_if(stmt.column_count() < 1, "zero columns");
 
@@ -189,7 +194,6 @@ vt_stmt::init_cache(fl::stmt& stmt)
         NULL /* TODO: unfortunate due to formatting limitations */
       FROM "meta", "data" USING(id)
       WHERE
-        (meta.id = :id)
 
     )SQL",
     fl::detail::str(px | fl::detail::prefix("meta.") |
@@ -222,6 +226,9 @@ vt_stmt::xConnect(bool const create)
 
   fl::error::raise_if(args.empty(), "missing argument");
 
+  key_sql_ =
+    "SELECT (" + kwarg("key").value_or("(SELECT RANDOMBLOB(16))") + ")";
+
   auto stmt = db().prepare("SELECT * FROM " + args.front());
 
   std::vector<std::string> column_defs;
@@ -263,9 +270,36 @@ vt_stmt::xBestIndex(fl::vtab::index_info& info)
         }
       }
     }
+
+    // IN lists on parameters are served with one cache entry for each
+    // value, IN lists on other columns end up in the cache query.
+    if (column.column_index >= 0) {
+      info.mark_in_lists(column.column_name);
+    }
+  }
+
+  auto parameters = fl::detail::safe_to<int>(std::ranges::count_if(
+    columns_, &fl::vtab::column::required));
+
+  // The cache query can stop early when it applies all constraints.
+  auto pushed_down = [](const fl::vtab::constraint_info& constraint) {
+    switch (constraint.op) {
+      case SQLITE_INDEX_CONSTRAINT_MATCH:
+      case SQLITE_INDEX_CONSTRAINT_REGEXP:
+      case SQLITE_INDEX_CONSTRAINT_FUNCTION:
+        return false;
+    }
+    return constraint.collation == "BINARY";
+  };
+
+  if (std::ranges::all_of(info.columns, [&](auto&& column) {
+        return column.column_index < parameters ||
+               std::ranges::all_of(column.constraints, pushed_down);
+      })) {
+    info.mark_limit();
   }
 
-  auto create_index_sql = to_create_index("data", info);
+  auto create_index_sql = to_create_index("data", info, parameters);
   if (!create_index_sql.empty()) {
     cache_->db.prepare(create_index_sql).execute();
   }
@@ -276,7 +310,9 @@ vt_stmt::xBestIndex(fl::vtab::index_info& info)
 void
 vt_stmt::xClose(cursor* cursor)
 {
-  cache_->change_meta_refcount(cursor->id_, -cursor->used_);
+  for (auto&& id : cursor->ids_) {
+    cache_->change_meta_refcount(id, -cursor->used_);
+  }
 }
 
 
@@ -288,19 +324,35 @@ vt_stmt::xFilter(const fl::vtab::index_info& info, cursor* cursor)
 
   // TODO: transaction?
 
-  auto inputs =
-    columns_ | std::views::filter(&fl::vtab::column::required) |
-    std::views::transform([&info](auto&& e) {
-      return info.columns[e.index + 1].constraints[0].current_value.value();
-    });
+  // Entries of an earlier xFilter call on this cursor are no longer used.
+  for (auto&& id : cursor->ids_) {
+    cache->change_meta_refcount(id, -cursor->used_);
+  }
 
-  cache->insert_meta_stmt
-    .reset() //
-    .bind(":key", cursor->key_)
-    .execute(inputs);
+  cursor->ids_.clear();
+
+  // xClose will later undo the refcount update of the entries in `ids_`,
+  // which only has those that got the update.
+  cursor->used_ = 1;
+
+  // One cache entry for each combination of parameter values, more than
+  // one when parameters are constrained with IN lists.
+  std::vector<std::vector<fl::value::variant>> inputs_list = { {} };
+
+  for (auto&& column :
+       columns_ | std::views::filter(&fl::vtab::column::required)) {
+    std::vector<std::vector<fl::value::variant>> extended;
+
+    for (auto&& value :
+         info.columns[column.index + 1].constraints[0].current_values()) {
+      for (auto&& inputs : inputs_list) {
+        extended.push_back(inputs);
+        extended.back().push_back(value);
+      }
+    }
 
-  // log("D: INSERT INTO meta SQL:\n{}",
-  // cache->insert_meta_stmt.expanded_sql());
+    inputs_list = std::move(extended);
+  }
 
   struct insert_meta_data
   {
@@ -308,56 +360,77 @@ vt_stmt::xFilter(const fl::vtab::index_info& info, cursor* cursor)
     int64_t refcount;
   };
 
-  auto first = cache->insert_meta_stmt | fl::as<insert_meta_data>();
+  for (auto&& inputs : inputs_list) {
 
-  auto insert_meta_row = *first.begin();
+    cache->insert_meta_stmt
+      .reset() //
+      .bind(":key", cursor->key_)
+      .execute(inputs);
 
-  cursor->id_ = insert_meta_row.id;
+    // log("D: INSERT INTO meta SQL:\n{}",
+    // cache->insert_meta_stmt.expanded_sql());
 
-  // log("D: INSERT INTO meta RETURNING id {}, refcount {}",
-  //     insert_meta_row.id,
-  //     insert_meta_row.refcount);
+    auto first = cache->insert_meta_stmt | fl::as<insert_meta_data>();
 
-  if (insert_meta_row.refcount < 0) {
+    auto insert_meta_row = *first.begin();
 
-    auto user_stmt = db().prepare("SELECT * FROM " + arguments().front());
-    user_stmt.execute(inputs);
+    // NOTE: a pending INSERT ... RETURNING would keep the bulk insert below
+    // from opening its savepoint.
+    cache->insert_meta_stmt.reset();
 
-    // log("D: SELECT user SQL:\n{}", user_stmt.expanded_sql());
+    // log("D: INSERT INTO meta RETURNING id {}, refcount {}",
+    //     insert_meta_row.id,
+    //     insert_meta_row.refcount);
 
-    cache->insert_data_stmt
-      .reset() //
-      .clear_bindings()
-      .bind(":id", insert_meta_row.id)
-      .executemany(user_stmt);
+    if (insert_meta_row.refcount < 0) {
+
+      auto user_stmt = db().prepare("SELECT * FROM " + arguments().front());
+      user_stmt.execute(inputs);
+
+      // log("D: SELECT user SQL:\n{}", user_stmt.expanded_sql());
+
+      cache->insert_data_stmt
+        .reset() //
+        .clear_bindings()
+        .bind(":id", insert_meta_row.id)
+        .executemany(user_stmt, {});
+
+      cache->change_meta_refcount(insert_meta_row.id, +1);
+    }
 
     cache->change_meta_refcount(insert_meta_row.id, +1);
-  }
 
-  cache->change_meta_refcount(insert_meta_row.id, +1);
+    cursor->ids_.push_back(insert_meta_row.id);
+  }
 
-  // xClose will later undo the refcount update, but xClose might also
-  // be called if we did not get to update the refcount to begin with.
-  cursor->used_ = 1;
+  std::string ids;
+  for (auto&& id : cursor->ids_) {
+    ids += (ids.empty() ? "" : ", ") + std::to_string(id);
+  }
 
-  auto constrained_select = cache->select_sql;
+  auto constrained_select = cache->select_sql + " (meta.id IN (" + ids + "))";
 
 #if 1
   // TODO: move this to bestindex
 
-  auto constraints = to_where_fragment("data", info);
+  auto parameters = fl::detail::safe_to<int>(std::ranges::count_if(
+    columns_, &fl::vtab::column::required));
+
+  auto constraints = to_where_fragment("data", info, parameters);
 
   if (!constraints.empty()) {
     constrained_select += " AND (" + constraints + ")";
   }
 #endif
 
+  if (auto rows = info.rows_wanted()) {
+    constrained_select += " LIMIT " + std::to_string(*rows);
+  }
+
   // log("D: vt_stmt xFilter called {}.\n", constrained_select);
 
   auto stmt = cache->db.prepare(constrained_select);
 
-  stmt.bind(":id", insert_meta_row.id);
-
   // log("D: Cache retrieval SQL:\n{}\n(for {})\n{}\n", stmt.expanded_sql(), arguments().front());
 
   stmt.execute();
@@ -37,10 +37,14 @@ public:
 
   std::optional<cache> cache_;
 
+  // Query for the `key` of each cursor.
+  std::string key_sql_;
+
   struct cursor
   {
     fl::value::variant key_;
-    int64_t id_ = 0;
+    // Cache entries of the last xFilter call.
+    std::vector<int64_t> ids_;
     int64_t used_ = 0;
 
     cursor(vt_stmt* vtab);
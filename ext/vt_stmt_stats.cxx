@@ -0,0 +1,80 @@
+#include "federlieb/federlieb.hxx"
+#include "vt_stmt_stats.hxx"
+
+namespace fl = ::federlieb;
+
+void
+vt_stmt_stats::xConnect(bool create)
+{
+  declare(R"SQL(
+      CREATE TABLE fl_stmt_stats(
+        sql TEXT,
+        runs INT,
+        total_ns INT,
+        max_ns INT,
+        p50_ns INT,
+        p90_ns INT,
+        p99_ns INT,
+        fullscan_steps INT,
+        sorts INT,
+        autoindex INT,
+        vm_steps INT,
+        reprepares INT,
+        memory_used INT,
+        histogram TEXT
+      )
+    )SQL");
+
+  // Collection starts with the first use of the table on a connection,
+  // unless the application called `fl::db::profile()` earlier.
+  fl::stmt_profiler::install(db().ptr().get());
+}
+
+bool
+vt_stmt_stats::xBestIndex(fl::vtab::index_info& info)
+{
+  return true;
+}
+
+vt_stmt_stats::result_type
+vt_stmt_stats::xFilter(const fl::vtab::index_info& info, cursor* cursor)
+{
+  result_type result;
+
+  auto profiler = fl::stmt_profiler::find(db().ptr().get());
+
+  if (!profiler) {
+    return result;
+  }
+
+  auto integer = [](auto const value) {
+    return fl::value::integer{ fl::detail::safe_to<sqlite3_int64>(
+      std::min<uint64_t>(value, INT64_MAX)) };
+  };
+
+  for (auto&& e : profiler->snapshot()) {
+
+    boost::json::array histogram;
+
+    for (auto&& bucket : e.histogram) {
+      histogram.push_back(bucket);
+    }
+
+    result.push_back({ fl::value::text{ e.sql },
+                       integer(e.runs),
+                       integer(e.total_ns),
+                       integer(e.max_ns),
+                       integer(e.percentile_ns(0.50)),
+                       integer(e.percentile_ns(0.90)),
+                       integer(e.percentile_ns(0.99)),
+                       fl::value::integer{ e.counters.fullscan_steps },
+                       fl::value::integer{ e.counters.sorts },
+                       fl::value::integer{ e.counters.autoindex },
+                       fl::value::integer{ e.counters.vm_steps },
+                       fl::value::integer{ e.counters.reprepares },
+                       fl::value::integer{ e.counters.memory_used },
+                       fl::value::text{ boost::json::serialize(histogram) } });
+  }
+
+  return result;
+}
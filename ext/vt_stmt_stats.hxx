@@ -0,0 +1,23 @@
+#pragma once
+
+#include "federlieb/vtab.hxx"
+
+namespace fl = ::federlieb;
+
+class vt_stmt_stats : public fl::vtab::base<vt_stmt_stats>
+{
+public:
+  static inline char const* const name = "fl_stmt_stats";
+  static inline bool const eponymous = true;
+
+  using result_type = std::list<std::array<fl::value::variant, 14>>;
+
+  struct cursor
+  {
+    cursor(vt_stmt_stats* vtab) {}
+  };
+
+  void xConnect(bool create);
+  bool xBestIndex(fl::vtab::index_info& info);
+  result_type xFilter(const fl::vtab::index_info& info, cursor* cursor);
+};
@@ -1,7 +1,3 @@
-#pragma GCC diagnostic ignored "-Wconversion"
-
-#include <boost/graph/transitive_closure.hpp>
-
 #include "federlieb/federlieb.hxx"
 
 #include "vt_transitive_closure.hxx"
@@ -31,16 +27,57 @@ vt_transitive_closure::result_type
 vt_transitive_closure::xFilter(const fl::vtab::index_info& info, cursor* cursor)
 {
 
-  decltype(cursor->g_.graph_) tc_graph;
+  // NOTE: like `boost::transitive_closure`, a vertex reaches itself only
+  // on a cycle, so each search starts from the successors.
+  struct search
+  {
+    variant_graph<Directed>* g;
+    size_t source = 0;
+    bool started = false;
+    // Vertices seen by the search from `source` are marked `1 + source`.
+    std::vector<size_t> seen{};
+    std::vector<size_t> stack{};
+
+    std::optional<row> next()
+    {
+      auto n = boost::num_vertices(g->graph_);
+
+      seen.resize(n);
+
+      while (source < n) {
+        if (!started) {
+          push_successors(source);
+          started = true;
+        }
+
+        if (stack.empty()) {
+          ++source;
+          started = false;
+          continue;
+        }
+
+        auto v = stack.back();
+        stack.pop_back();
+        push_successors(v);
 
-  boost::transitive_closure(cursor->g_.graph_, tc_graph);
+        return row{ g->variant_ptr(source), g->variant_ptr(v) };
+      }
 
-  result_type result;
+      return std::nullopt;
+    }
 
-  for (auto e : boost::make_iterator_range(boost::edges(tc_graph))) {
-    result.push_back({ cursor->g_.variant(boost::source(e, tc_graph)),
-                       cursor->g_.variant(boost::target(e, tc_graph)) });
-  }
+    void push_successors(size_t const v)
+    {
+      for (auto w : boost::make_iterator_range(
+             boost::adjacent_vertices(v, g->graph_))) {
+        if (seen[w] != 1 + source) {
+          seen[w] = 1 + source;
+          stack.push_back(w);
+        }
+      }
+    }
+  };
 
-  return result;
+  return result_type(
+    [s = search{ &cursor->g_ }]() mutable { return s.next(); });
 }
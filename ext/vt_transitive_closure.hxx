@@ -11,7 +11,15 @@ class vt_transitive_closure : public fl::vtab::base<vt_transitive_closure>
 public:
   static inline char const* const name = "fl_transitive_closure";
 
-  using result_type = std::list<std::array<fl::value::variant, 2>>;
+  struct row
+  {
+    fl::value::variant const* src;
+    fl::value::variant const* dst;
+  };
+
+  // Pairs are found by a search from each vertex as xNext gets to them,
+  // the closure is never stored.
+  using result_type = fl::vtab::generator<row>;
 
   struct cursor
   {
@@ -28,7 +28,37 @@ namespace federlieb {
 
 namespace fl = ::federlieb;
 
-template<typename F, std::integral T, typename... Args>
+// How `fl::api` guards calls that report a result code against other
+// threads using the same connection, so that `sqlite3_errmsg` reports the
+// error of the failed call.
+//
+//   * `single_thread`: the connection is only ever used by one thread.
+//     No locking at all; `fl::db::open` adds `SQLITE_OPEN_NOMUTEX`.
+//   * `serialized_by_sqlite`: SQLite serializes every call itself and
+//     `fl::api` does not lock again; `fl::db::open` adds
+//     `SQLITE_OPEN_FULLMUTEX`. Error messages can be from another thread.
+//   * `explicit_lock`: `fl::api` holds the recursive connection mutex
+//     for the duration of the call and the error message lookup.
+//
+// The default is chosen at build time through `FEDERLIEB_THREADING` and
+// can be overridden per call, `fl::api<fl::threading::single_thread>(...)`.
+enum class threading
+{
+  single_thread,
+  serialized_by_sqlite,
+  explicit_lock
+};
+
+#ifdef FEDERLIEB_THREADING
+inline constexpr auto default_threading = threading::FEDERLIEB_THREADING;
+#else
+inline constexpr auto default_threading = threading::explicit_lock;
+#endif
+
+template<threading Policy = default_threading,
+         typename F,
+         std::integral T,
+         typename... Args>
 int
 api(F f, std::initializer_list<T> expected_codes, sqlite3* db, Args... args)
 {
@@ -36,7 +66,11 @@ api(F f, std::initializer_list<T> expected_codes, sqlite3* db, Args... args)
 
   sqlite3_mutex* mutex = nullptr;
 
-  bool use_mutex = sqlite3_threadsafe() && db != nullptr;
+  bool use_mutex = false;
+
+  if constexpr (Policy == threading::explicit_lock) {
+    use_mutex = sqlite3_threadsafe() && db != nullptr;
+  }
 
   if (use_mutex) {
     mutex = sqlite3_db_mutex(db);
@@ -2,35 +2,286 @@
 #define FEDERLIEB_AS_HXX
 
 #include <boost/pfr.hpp>
+#include <array>
+#include <cctype>
+#include <optional>
 #include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "federlieb/row.hxx"
+#include "federlieb/stmt.hxx"
 
 namespace federlieb {
 
 namespace fl = ::federlieb;
 
+namespace detail {
+
 template<typename T>
-requires std::is_default_constructible_v<T>
-auto
-as()
+struct is_optional : std::false_type
+{};
+
+template<typename T>
+struct is_optional<std::optional<T>> : std::true_type
+{};
+
+// Column affinity as derived from a declared type, see section 3.1 of
+// https://www.sqlite.org/datatype3.html
+inline int
+declared_affinity(std::string decl)
+{
+  for (auto&& c : decl) {
+    c = std::toupper(static_cast<unsigned char>(c));
+  }
+
+  if (decl.find("INT") != std::string::npos) {
+    return SQLITE_INTEGER;
+  } else if (decl.find("CHAR") != std::string::npos ||
+             decl.find("CLOB") != std::string::npos ||
+             decl.find("TEXT") != std::string::npos) {
+    return SQLITE_TEXT;
+  } else if (decl.empty() || decl.find("BLOB") != std::string::npos) {
+    return SQLITE_BLOB;
+  } else if (decl.find("REAL") != std::string::npos ||
+             decl.find("FLOA") != std::string::npos ||
+             decl.find("DOUB") != std::string::npos) {
+    return SQLITE_FLOAT;
+  }
+
+  return SQLITE_NULL; // NUMERIC
+}
+
+// Whether a column declared with `affinity` can be read into a `T` at all.
+// Values are still checked one by one, since the declared type does not
+// constrain what a column holds.
+template<typename T>
+inline bool
+accepts_affinity(int const affinity)
+{
+  if constexpr (is_optional<T>::value) {
+    return accepts_affinity<typename T::value_type>(affinity);
+  } else if constexpr (std::integral<T> || std::same_as<T, double>) {
+    return affinity != SQLITE_TEXT;
+  } else if constexpr (std::same_as<T, std::string> ||
+                       std::same_as<T, fl::blob_type>) {
+    return affinity != SQLITE_INTEGER && affinity != SQLITE_FLOAT;
+  } else {
+    return true;
+  }
+}
+
+template<typename T>
+inline void
+extract(sqlite3* db, sqlite3_stmt* stmt, int const column, T& sink)
 {
-  return std::ranges::views::transform([](fl::row&& row) {
-    int sink_size = boost::pfr::tuple_size<T>();
+  auto type = fl::api(sqlite3_column_type, db, stmt, column);
 
-    if (sink_size > row.size()) {
-      fl::error::raise("as() needs more columns than those returned");
+  if constexpr (is_optional<T>::value) {
+    if (SQLITE_NULL == type) {
+      sink = std::nullopt;
+    } else {
+      extract(db, stmt, column, sink.emplace());
     }
+  } else if constexpr (std::integral<T>) {
+    fl::error::raise_if(type != SQLITE_INTEGER, "not an INTEGER field");
+    sink = fl::detail::safe_to<T>(
+      fl::api(sqlite3_column_int64, db, stmt, column));
+  } else if constexpr (std::same_as<T, double>) {
+    fl::error::raise_if(type != SQLITE_FLOAT, "not a REAL field");
+    sink = fl::api(sqlite3_column_double, db, stmt, column);
+  } else if constexpr (std::same_as<T, std::string>) {
+    fl::error::raise_if(type != SQLITE_TEXT, "not a TEXT field");
+    auto data = (const char*)fl::api(sqlite3_column_text, db, stmt, column);
+    sink.assign(data, fl::api(sqlite3_column_bytes, db, stmt, column));
+  } else if constexpr (std::same_as<T, fl::blob_type>) {
+    fl::error::raise_if(type != SQLITE_BLOB, "not a BLOB field");
+    auto data = static_cast<fl::blob_type::value_type const*>(
+      fl::api(sqlite3_column_blob, db, stmt, column));
+    sink.assign(data, data + fl::api(sqlite3_column_bytes, db, stmt, column));
+  } else {
+    static_assert(std::same_as<T, fl::value::variant>);
+
+    switch (type) {
+      case SQLITE_INTEGER:
+        sink = fl::value::integer{ fl::api(
+          sqlite3_column_int64, db, stmt, column) };
+        break;
+      case SQLITE_FLOAT:
+        sink = fl::value::real{ fl::api(
+          sqlite3_column_double, db, stmt, column) };
+        break;
+      case SQLITE_TEXT: {
+        fl::value::text text;
+        extract(db, stmt, column, text.value);
+        sink = std::move(text);
+        break;
+      }
+      case SQLITE_BLOB: {
+        fl::value::blob blob;
+        extract(db, stmt, column, blob.value);
+        sink = std::move(blob);
+        break;
+      }
+      default:
+        sink = fl::value::null{};
+    }
+  }
+}
+
+}
+
+// Decodes the rows of a statement into `T`. The column layout is checked
+// once per statement: the column count, the declared types against the
+// field types, and, if field names are given, which column each field is
+// read from. Rows are then decoded through a table of per-field extractors.
+template<typename T>
+class row_decoder
+{
+public:
+  static constexpr auto field_count = boost::pfr::tuple_size_v<T>;
+
+  row_decoder() = default;
+
+  // `names` are the column names for the fields of `T`, in field order.
+  explicit row_decoder(std::vector<std::string> names)
+    : names_(std::move(names))
+  {
+    fl::error::raise_if(names_.size() != field_count,
+                        "as() needs one name per field");
+  }
+
+  T operator()(const fl::row& row)
+  {
+    auto stmt = row.stmt_->stmt_.get();
+    auto db = row.stmt_->db();
+
+    if (stmt != checked_) {
+      check(db, stmt, row.size());
+    }
+
+    static constexpr auto extractors =
+      make_extractors(std::make_index_sequence<field_count>());
 
     T sink;
 
-    boost::pfr::for_each_field(
-      sink, [&row](auto&& value, int index) { row.at(index).to(value); });
+    for (size_t ix = 0; ix < field_count; ++ix) {
+      extractors[ix](db, stmt, columns_[ix], sink);
+    }
 
     return sink;
-  });
+  }
+
+protected:
+  using extractor = void (*)(sqlite3*, sqlite3_stmt*, int const, T&);
+
+  template<size_t... Is>
+  static constexpr std::array<extractor, field_count> make_extractors(
+    std::index_sequence<Is...>)
+  {
+    return { [](sqlite3* db, sqlite3_stmt* stmt, int const column, T& sink) {
+      fl::detail::extract(db, stmt, column, boost::pfr::get<Is>(sink));
+    }... };
+  }
+
+  template<size_t... Is>
+  void check_affinities(sqlite3* db,
+                        sqlite3_stmt* stmt,
+                        std::index_sequence<Is...>)
+  {
+    auto accepts = [&](auto index, auto* field) {
+      using field_type = std::remove_pointer_t<decltype(field)>;
+      auto decl = fl::api(sqlite3_column_decltype, db, stmt, columns_[index]);
+
+      // Expressions have no declared type.
+      if (nullptr == decl) {
+        return true;
+      }
+
+      return fl::detail::accepts_affinity<field_type>(
+        fl::detail::declared_affinity(decl));
+    };
+
+    bool ok = (accepts(Is, (boost::pfr::tuple_element_t<Is, T>*)nullptr) &&
+               ...);
+
+    fl::error::raise_if(!ok, "as() field type does not fit declared type");
+  }
+
+  void check(sqlite3* db, sqlite3_stmt* stmt, int const column_count)
+  {
+    if (names_.empty()) {
+      if (int(field_count) > column_count) {
+        fl::error::raise("as() needs more columns than those returned");
+      }
+
+      for (size_t ix = 0; ix < field_count; ++ix) {
+        columns_[ix] = ix;
+      }
+
+    } else {
+      for (size_t ix = 0; ix < field_count; ++ix) {
+        columns_[ix] = -1;
+
+        for (int column = 0; column < column_count; ++column) {
+          auto name = fl::api(sqlite3_column_name, db, stmt, column);
+
+          if (nullptr != name && names_[ix] == name) {
+            columns_[ix] = column;
+            break;
+          }
+        }
+
+        fl::error::raise_if(columns_[ix] < 0, "as() found no column by name");
+      }
+    }
+
+    check_affinities(db, stmt, std::make_index_sequence<field_count>());
+
+    checked_ = stmt;
+  }
+
+  std::vector<std::string> names_;
+  std::array<int, field_count> columns_{};
+  sqlite3_stmt* checked_ = nullptr;
+};
+
+template<typename T>
+requires std::is_default_constructible_v<T>
+auto
+as()
+{
+  return std::ranges::views::transform(
+    [decoder = fl::row_decoder<T>()](fl::row&& row) mutable {
+      return decoder(row);
+    });
 }
 
+// Like `as()`, but reads each field from the column with the given name.
+template<typename T>
+requires std::is_default_constructible_v<T>
+auto
+as(std::vector<std::string> names)
+{
+  return std::ranges::views::transform(
+    [decoder = fl::row_decoder<T>(std::move(names))](fl::row&& row) mutable {
+      return decoder(row);
+    });
+}
+
+#if defined(BOOST_PFR_CORE_NAME_ENABLED) && BOOST_PFR_CORE_NAME_ENABLED
+// Like `as(names)`, using the field names of `T` (Boost.PFR 1.84+).
+template<typename T>
+requires std::is_default_constructible_v<T>
+auto
+as_by_name()
+{
+  auto names = boost::pfr::names_as_array<T>();
+  return fl::as<T>(std::vector<std::string>(names.begin(), names.end()));
+}
+#endif
+
 }
 
 #endif
@@ -0,0 +1,88 @@
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+std::string_view
+fl::batch::text(size_t const column, size_t const row) const
+{
+  auto data = blob(column, row);
+
+  return std::string_view(reinterpret_cast<char const*>(data.data()),
+                          data.size());
+}
+
+std::span<const std::byte>
+fl::batch::blob(size_t const column, size_t const row) const
+{
+  fl::error::raise_if(column >= columns_.size() || row >= rows_,
+                      "out of range");
+
+  auto& data = columns_[column];
+
+  return std::span<const std::byte>(arena_).subspan(data.offsets[row],
+                                                    data.lengths[row]);
+}
+
+void
+fl::batch::clear()
+{
+  rows_ = 0;
+  arena_.clear();
+
+  for (auto&& column : columns_) {
+    column.types.clear();
+    column.integers.clear();
+    column.reals.clear();
+    column.nulls.clear();
+    column.offsets.clear();
+    column.lengths.clear();
+  }
+}
+
+void
+fl::batch::start(int const column_count, size_t const reserve)
+{
+  columns_.resize(column_count);
+
+  clear();
+
+  for (auto&& column : columns_) {
+    column.types.reserve(reserve);
+    column.integers.reserve(reserve);
+    column.reals.reserve(reserve);
+    column.nulls.reserve((reserve + 63) / 64);
+    column.offsets.reserve(reserve);
+    column.lengths.reserve(reserve);
+  }
+}
+
+void
+fl::batch::append(fl::batch::column& column,
+                  int const type,
+                  sqlite3_int64 const integer,
+                  double const real,
+                  const void* data,
+                  size_t const bytes)
+{
+  auto row = column.types.size();
+
+  if (row % 64 == 0) {
+    column.nulls.push_back(0);
+  }
+
+  if (SQLITE_NULL == type) {
+    column.nulls.back() |= uint64_t(1) << (row % 64);
+  }
+
+  column.offsets.push_back(arena_.size());
+  column.lengths.push_back(bytes);
+
+  if (bytes > 0) {
+    auto begin = static_cast<std::byte const*>(data);
+    arena_.insert(arena_.end(), begin, begin + bytes);
+  }
+
+  column.types.push_back(type);
+  column.integers.push_back(integer);
+  column.reals.push_back(real);
+}
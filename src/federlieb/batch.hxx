@@ -0,0 +1,82 @@
+#ifndef FEDERLIEB_BATCH_HXX
+#define FEDERLIEB_BATCH_HXX
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "api.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+class stmt;
+
+// Structure-of-arrays copy of up to `n` result rows, as filled by
+// `fl::stmt::fetch_batch`. Every column has one vector per storage class,
+// indexed by row, holding zero where the row has another type, a NULL
+// bitmap, and offsets and lengths into an arena shared by all TEXT and
+// BLOB values of the batch. Filling a batch again keeps the capacity of
+// all vectors.
+class batch
+{
+public:
+  struct column
+  {
+    std::string name;
+
+    // `SQLITE_INTEGER`, `SQLITE_FLOAT`, ... for each row.
+    std::vector<uint8_t> types;
+    std::vector<sqlite3_int64> integers;
+    std::vector<double> reals;
+
+    // Bit `row % 64` of `nulls[row / 64]` is set when the row is NULL.
+    std::vector<uint64_t> nulls;
+
+    // TEXT and BLOB values start at `arena[offsets[row]]`, zero otherwise.
+    std::vector<size_t> offsets;
+    std::vector<size_t> lengths;
+
+    bool is_null(size_t const row) const
+    {
+      return nulls[row / 64] & (uint64_t(1) << (row % 64));
+    }
+  };
+
+  size_t size() const { return rows_; }
+  bool empty() const { return 0 == rows_; }
+
+  const std::vector<column>& columns() const { return columns_; }
+  const column& operator[](size_t const index) const
+  {
+    return columns_[index];
+  }
+
+  std::string_view text(size_t const column, size_t const row) const;
+  std::span<const std::byte> blob(size_t const column, size_t const row) const;
+  std::span<const std::byte> arena() const { return arena_; }
+
+  void clear();
+
+protected:
+  friend class fl::stmt;
+
+  void start(int const column_count, size_t const reserve);
+  void append(fl::batch::column& column,
+              int const type,
+              sqlite3_int64 const integer,
+              double const real,
+              const void* data,
+              size_t const bytes);
+
+  size_t rows_ = 0;
+  std::vector<column> columns_;
+  std::vector<std::byte> arena_;
+};
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+fl::blob_stream::blob_stream(std::shared_ptr<sqlite3> db,
+                             const std::string& schema,
+                             const std::string& table,
+                             const std::string& column,
+                             sqlite3_int64 const rowid,
+                             bool const writable)
+  : db_(db)
+{
+  sqlite3_blob* blob = nullptr;
+
+  fl::api(sqlite3_blob_open,
+          { SQLITE_OK },
+          db_.get(),
+          db_.get(),
+          schema.c_str(),
+          table.c_str(),
+          column.c_str(),
+          rowid,
+          writable ? 1 : 0,
+          &blob);
+
+  fl::error::raise_if(nullptr == blob, "sqlite3_blob_open returned nullptr");
+
+  blob_ = std::shared_ptr<sqlite3_blob>(blob, [](sqlite3_blob* blob) {
+    // NOTE: This must not use fl::api.
+    sqlite3_blob_close(blob);
+  });
+}
+
+size_t
+fl::blob_stream::size() const
+{
+  return fl::api(sqlite3_blob_bytes, db(), blob_.get());
+}
+
+size_t
+fl::blob_stream::read(std::span<std::byte> buffer, size_t const offset) const
+{
+  auto total = size();
+
+  if (offset >= total) {
+    return 0;
+  }
+
+  auto n = std::min(buffer.size(), total - offset);
+
+  fl::api(sqlite3_blob_read,
+          { SQLITE_OK },
+          db(),
+          blob_.get(),
+          buffer.data(),
+          fl::detail::safe_to<int>(n),
+          fl::detail::safe_to<int>(offset));
+
+  return n;
+}
+
+void
+fl::blob_stream::write(std::span<const std::byte> data, size_t const offset)
+{
+  fl::error::raise_if(offset + data.size() > size(),
+                      "cannot write past the end of a BLOB");
+
+  fl::api(sqlite3_blob_write,
+          { SQLITE_OK },
+          db(),
+          blob_.get(),
+          data.data(),
+          fl::detail::safe_to<int>(data.size()),
+          fl::detail::safe_to<int>(offset));
+}
+
+size_t
+fl::blob_stream::read(std::span<std::byte> buffer)
+{
+  auto n = read(buffer, position_);
+  position_ += n;
+  return n;
+}
+
+void
+fl::blob_stream::write(std::span<const std::byte> data)
+{
+  write(data, position_);
+  position_ += data.size();
+}
+
+void
+fl::blob_stream::seek(size_t const position)
+{
+  fl::error::raise_if(position > size(), "cannot seek past the end");
+  position_ = position;
+}
+
+void
+fl::blob_stream::reopen(sqlite3_int64 const rowid)
+{
+  fl::api(sqlite3_blob_reopen, { SQLITE_OK }, db(), blob_.get(), rowid);
+  position_ = 0;
+}
+
+fl::blob_chunk_view
+fl::blob_stream::chunks(size_t const chunk_size)
+{
+  return fl::blob_chunk_view(*this, chunk_size);
+}
+
+fl::blob_chunk_view::blob_chunk_view(fl::blob_stream& stream,
+                                     size_t const chunk_size)
+  : stream_(&stream)
+  , buffer_(chunk_size)
+{
+  fl::error::raise_if(0 == chunk_size, "chunk_size must not be zero");
+  next();
+}
+
+void
+fl::blob_chunk_view::next()
+{
+  filled_ = stream_->read(buffer_);
+}
+
+bool
+fl::blob_chunk_iterator::operator==(
+  const fl::blob_chunk_iterator::sentinel&) const
+{
+  return 0 == view_->filled_;
+}
+
+std::span<const std::byte>
+fl::blob_chunk_iterator::operator*() const
+{
+  return std::span<const std::byte>(view_->buffer_.data(), view_->filled_);
+}
+
+fl::blob_chunk_iterator&
+fl::blob_chunk_iterator::operator++()
+{
+  view_->next();
+  return *this;
+}
+
+static_assert(std::input_iterator<fl::blob_chunk_iterator>);
+static_assert(std::ranges::range<fl::blob_chunk_view>);
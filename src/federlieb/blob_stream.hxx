@@ -0,0 +1,115 @@
+#ifndef FEDERLIEB_BLOB_STREAM_HXX
+#define FEDERLIEB_BLOB_STREAM_HXX
+
+#include <boost/stl_interfaces/iterator_interface.hpp>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "api.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+class blob_chunk_view;
+
+// Incremental I/O on a single BLOB through `sqlite3_blob_*`, without
+// copying the whole value. Reads and writes cannot go past `size()`, a
+// BLOB cannot be resized this way. `reopen` moves the handle to the same
+// column of another row. As with `sqlite3_blob_open`, any change to the
+// row through other means invalidates the handle.
+class blob_stream
+{
+public:
+  blob_stream(std::shared_ptr<sqlite3> db,
+              const std::string& schema,
+              const std::string& table,
+              const std::string& column,
+              sqlite3_int64 const rowid,
+              bool const writable = false);
+
+  size_t size() const;
+
+  // Copy up to `buffer.size()` bytes starting at `offset`, returns the
+  // number of bytes copied, which is less only at the end of the BLOB.
+  size_t read(std::span<std::byte> buffer, size_t const offset) const;
+  void write(std::span<const std::byte> data, size_t const offset);
+
+  // Sequential variants of the above that start at and advance `tell()`.
+  size_t read(std::span<std::byte> buffer);
+  void write(std::span<const std::byte> data);
+
+  size_t tell() const { return position_; }
+  void seek(size_t const position);
+
+  void reopen(sqlite3_int64 const rowid);
+
+  // Range of `std::span<const std::byte>` of at most `chunk_size` bytes
+  // each, from `tell()` to the end, backed by one reused buffer.
+  fl::blob_chunk_view chunks(size_t const chunk_size = 64 * 1024);
+
+protected:
+  sqlite3* db() const { return db_.get(); }
+
+  std::shared_ptr<sqlite3> db_;
+  std::shared_ptr<sqlite3_blob> blob_;
+  size_t position_ = 0;
+};
+
+class blob_chunk_iterator
+  : public boost::stl_interfaces::iterator_interface<
+      fl::blob_chunk_iterator,
+      std::input_iterator_tag,
+      std::span<const std::byte>,
+      std::span<const std::byte>>
+{
+public:
+  using boost::stl_interfaces::iterator_interface<
+    fl::blob_chunk_iterator,
+    std::input_iterator_tag,
+    std::span<const std::byte>,
+    std::span<const std::byte>>::operator++;
+
+  blob_chunk_iterator() {}
+
+  explicit blob_chunk_iterator(fl::blob_chunk_view* view)
+    : view_(view)
+  {}
+
+  struct sentinel
+  {};
+
+  bool operator==(const fl::blob_chunk_iterator::sentinel&) const;
+
+  std::span<const std::byte> operator*() const;
+
+  blob_chunk_iterator& operator++();
+
+protected:
+  fl::blob_chunk_view* view_ = nullptr;
+};
+
+class blob_chunk_view
+{
+public:
+  blob_chunk_view(fl::blob_stream& stream, size_t const chunk_size);
+
+  fl::blob_chunk_iterator begin() { return fl::blob_chunk_iterator(this); }
+  fl::blob_chunk_iterator::sentinel end() { return {}; }
+
+protected:
+  friend class fl::blob_chunk_iterator;
+
+  void next();
+
+  fl::blob_stream* stream_ = nullptr;
+  std::vector<std::byte> buffer_;
+  size_t filled_ = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+double
+fl::bulk_stats::rows_per_second() const
+{
+  return seconds > 0 ? rows / seconds : 0;
+}
+
+fl::bulk_transaction::bulk_transaction(sqlite3* db,
+                                       const fl::bulk_options& options)
+  : db_(db)
+  , options_(options)
+  , start_(std::chrono::steady_clock::now())
+{
+  fl::error::raise_if(options_.rebuild_indexes && options_.table.empty(),
+                      "rebuild_indexes needs a table");
+
+  exec("SAVEPOINT fl_bulk");
+  open_ = true;
+
+  if (options_.rebuild_indexes) {
+    drop_indexes();
+  }
+}
+
+fl::bulk_transaction::~bulk_transaction()
+{
+  if (open_) {
+    rollback();
+  }
+}
+
+void
+fl::bulk_transaction::exec(const std::string& sql)
+{
+  fl::api(sqlite3_exec,
+          { SQLITE_OK },
+          db_,
+          db_,
+          sql.c_str(),
+          nullptr,
+          nullptr,
+          nullptr);
+}
+
+void
+fl::bulk_transaction::drop_indexes()
+{
+  auto db = fl::db(std::shared_ptr<sqlite3>(db_, [](auto&&) {}));
+
+  auto stmt = db.prepare(fl::detail::sprintf(
+    R"SQL(
+      SELECT name, sql FROM "%w".sqlite_schema
+      WHERE type = 'index' AND tbl_name = %Q AND sql IS NOT NULL
+    )SQL",
+    options_.schema.c_str(),
+    options_.table.c_str()));
+
+  stmt.execute();
+
+  indexes_ = fl::detail::to_vector(stmt | fl::as<index_data>());
+
+  for (auto&& index : indexes_) {
+    exec(fl::detail::sprintf(R"(DROP INDEX "%w"."%w")",
+                             options_.schema.c_str(),
+                             index.name.c_str()));
+  }
+}
+
+void
+fl::bulk_transaction::create_indexes()
+{
+  for (auto&& index : indexes_) {
+    // NOTE: `sql` is as written by the user, without the schema name,
+    // hence the temporary change of the main schema is not an option;
+    // SQLite resolves unqualified CREATE INDEX against the table schema.
+    auto db = fl::db(std::shared_ptr<sqlite3>(db_, [](auto&&) {}));
+
+    auto exists = db.prepare(fl::detail::sprintf(
+      R"SQL(
+        SELECT 1 FROM "%w".sqlite_schema WHERE type = 'index' AND name = %Q
+      )SQL",
+      options_.schema.c_str(),
+      index.name.c_str()));
+
+    if (exists.execute().empty()) {
+      exec(index.sql);
+    }
+  }
+
+  indexes_.clear();
+}
+
+void
+fl::bulk_transaction::row_done(size_t const bytes)
+{
+  stats_.rows++;
+  stats_.bytes += bytes;
+  chunk_rows_++;
+  chunk_bytes_ += bytes;
+
+  bool full = (options_.chunk_rows && chunk_rows_ >= options_.chunk_rows) ||
+              (options_.chunk_bytes && chunk_bytes_ >= options_.chunk_bytes);
+
+  if (full) {
+    exec("RELEASE fl_bulk");
+    open_ = false;
+    stats_.chunks++;
+    chunk_rows_ = 0;
+    chunk_bytes_ = 0;
+    exec("SAVEPOINT fl_bulk");
+    open_ = true;
+  }
+}
+
+fl::bulk_stats
+fl::bulk_transaction::commit()
+{
+  create_indexes();
+
+  exec("RELEASE fl_bulk");
+  open_ = false;
+
+  if (chunk_rows_ > 0) {
+    stats_.chunks++;
+  }
+
+  stats_.seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start_)
+                     .count();
+
+  return stats_;
+}
+
+void
+fl::bulk_transaction::rollback() noexcept
+{
+  try {
+    exec("ROLLBACK TO fl_bulk");
+    exec("RELEASE fl_bulk");
+    open_ = false;
+
+    // Dropping the indexes may already have been committed with an
+    // earlier chunk.
+    create_indexes();
+
+  } catch (...) {
+    open_ = false;
+  }
+}
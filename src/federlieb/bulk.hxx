@@ -0,0 +1,114 @@
+#ifndef FEDERLIEB_BULK_HXX
+#define FEDERLIEB_BULK_HXX
+
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "api.hxx"
+
+#include "federlieb/detail.hxx"
+#include "federlieb/value.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+class field;
+
+struct bulk_options
+{
+  // Release the savepoint (which commits, unless a transaction was already
+  // open) after this many rows, or after roughly this many bytes of bound
+  // TEXT and BLOB data. Zero disables the respective limit.
+  size_t chunk_rows = 10000;
+  size_t chunk_bytes = 64 * 1024 * 1024;
+
+  // Drop the secondary indexes of `schema`.`table` before loading and
+  // re-create them afterwards. Automatic indexes for UNIQUE and PRIMARY
+  // KEY constraints cannot be dropped and are kept.
+  bool rebuild_indexes = false;
+  std::string schema = "main";
+  std::string table;
+};
+
+struct bulk_stats
+{
+  uint64_t rows = 0;
+  uint64_t bytes = 0;
+  uint64_t chunks = 0;
+  double seconds = 0;
+
+  double rows_per_second() const;
+};
+
+// Wraps a bulk load in `SAVEPOINT fl_bulk` and releases and re-opens the
+// savepoint whenever a chunk is complete. Destroying the object without
+// calling `commit()` rolls back the current chunk; earlier chunks stay.
+class bulk_transaction
+{
+public:
+  bulk_transaction(sqlite3* db, const fl::bulk_options& options);
+  ~bulk_transaction();
+
+  bulk_transaction(const bulk_transaction&) = delete;
+  bulk_transaction& operator=(const bulk_transaction&) = delete;
+
+  void row_done(size_t const bytes);
+  fl::bulk_stats commit();
+  void rollback() noexcept;
+
+protected:
+  struct index_data
+  {
+    std::string name;
+    std::string sql;
+  };
+
+  void exec(const std::string& sql);
+  void drop_indexes();
+  void create_indexes();
+
+  sqlite3* db_ = nullptr;
+  fl::bulk_options options_;
+  fl::bulk_stats stats_;
+  size_t chunk_rows_ = 0;
+  size_t chunk_bytes_ = 0;
+  bool open_ = false;
+  std::vector<index_data> indexes_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+namespace detail {
+
+// Approximate size of a bound value, used for `bulk_options::chunk_bytes`.
+template<typename T>
+inline size_t
+bound_bytes(const T& value)
+{
+  if constexpr (std::same_as<T, fl::field>) {
+    return (value.is_text() || value.is_blob()) ? value.bytes() : 8;
+  } else if constexpr (std::same_as<T, fl::value::variant>) {
+    return std::visit([](auto&& e) { return bound_bytes(e); }, value);
+  } else if constexpr (std::same_as<T, fl::value::text> ||
+                       std::same_as<T, fl::value::blob> ||
+                       std::same_as<T, fl::value::json>) {
+    return value.value.size();
+  } else if constexpr (requires { std::ranges::size(value); }) {
+    return std::ranges::size(value);
+  } else if constexpr (std::is_arithmetic_v<T> ||
+                       std::same_as<T, fl::value::integer> ||
+                       std::same_as<T, fl::value::real>) {
+    return 8;
+  } else {
+    return 0;
+  }
+}
+
+}
+
+}
+
+#endif
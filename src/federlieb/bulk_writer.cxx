@@ -0,0 +1,39 @@
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+double
+fl::bulk_writer_stats::rows_per_second() const
+{
+  return seconds > 0 ? rows / seconds : 0;
+}
+
+std::string
+fl::detail::bulk_insert_sql(const fl::bulk_writer_options& options,
+                            std::vector<std::string> columns,
+                            size_t const field_count)
+{
+  fl::error::raise_if(options.table.empty(), "bulk_writer needs a table");
+  fl::error::raise_if(!columns.empty() && columns.size() != field_count,
+                      "bulk_writer needs one column per field");
+
+  std::string sql = "INSERT INTO " +
+                    fl::detail::quote_identifier(options.schema) + "." +
+                    fl::detail::quote_identifier(options.table);
+
+  if (!columns.empty()) {
+    sql += "(";
+    for (size_t ix = 0; ix < columns.size(); ++ix) {
+      sql += (ix ? ", " : "") + fl::detail::quote_identifier(columns[ix]);
+    }
+    sql += ")";
+  }
+
+  sql += " VALUES(";
+  for (size_t ix = 0; ix < field_count; ++ix) {
+    sql += (ix ? ", ?" : "?") + std::to_string(ix + 1);
+  }
+  sql += ")";
+
+  return sql;
+}
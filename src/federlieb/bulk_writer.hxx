@@ -0,0 +1,315 @@
+#ifndef FEDERLIEB_BULK_WRITER_HXX
+#define FEDERLIEB_BULK_WRITER_HXX
+
+#include <boost/pfr.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api.hxx"
+
+#include "federlieb/as.hxx"
+#include "federlieb/bulk.hxx"
+#include "federlieb/db.hxx"
+#include "federlieb/stmt.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+struct bulk_writer_options
+{
+  std::string schema = "main";
+  std::string table;
+
+  // Column for each field, in field order. Without, the field names are
+  // used where Boost.PFR supports that, and all columns of the table in
+  // declared order otherwise.
+  std::vector<std::string> columns;
+
+  // Rows per transaction. Producers block once a full batch is waiting
+  // for the previous one to be committed.
+  size_t batch_rows = 10000;
+};
+
+struct bulk_writer_stats
+{
+  uint64_t rows = 0;
+  uint64_t batches = 0;
+  uint64_t bytes = 0;
+
+  // Time the commit thread spent inserting and committing.
+  double commit_seconds = 0;
+
+  // Back-pressure: how often and how long producers waited for the
+  // commit thread.
+  uint64_t waits = 0;
+  double wait_seconds = 0;
+
+  // Since the writer was created.
+  double seconds = 0;
+
+  double rows_per_second() const;
+};
+
+namespace detail {
+
+std::string
+bulk_insert_sql(const fl::bulk_writer_options& options,
+                std::vector<std::string> columns,
+                size_t const field_count);
+
+}
+
+// Inserts `T` objects into a table from a background thread. Rows are
+// collected in one buffer while the other is inserted and committed, one
+// transaction per batch, on the writer's own thread, which is the only
+// one that uses the connection. Fields are bound directly, TEXT and BLOB
+// without copying, see `fl::stmt::borrow`; `std::optional` fields bind
+// NULL when empty.
+//
+// An error on the commit thread is rethrown by the next `push` or
+// `flush`; the failed batch is rolled back and later rows are discarded.
+// The destructor commits what is left, errors are lost then.
+template<typename T>
+class bulk_writer
+{
+public:
+  static constexpr auto field_count = boost::pfr::tuple_size_v<T>;
+
+  bulk_writer(fl::db db, fl::bulk_writer_options options)
+    : db_(db)
+    , options_(std::move(options))
+    , start_(std::chrono::steady_clock::now())
+  {
+    fl::error::raise_if(options_.batch_rows < 1, "batch_rows must be > 0");
+
+    std::vector<std::string> columns = options_.columns;
+
+#if defined(BOOST_PFR_CORE_NAME_ENABLED) && BOOST_PFR_CORE_NAME_ENABLED
+    if (columns.empty()) {
+      auto names = boost::pfr::names_as_array<T>();
+      columns.assign(names.begin(), names.end());
+    }
+#endif
+
+    insert_stmt_ = db_.prepare(
+      fl::detail::bulk_insert_sql(options_, columns, field_count));
+
+    filling_.reserve(options_.batch_rows);
+    committing_.reserve(options_.batch_rows);
+
+    thread_ = std::thread([this] { run(); });
+  }
+
+  ~bulk_writer()
+  {
+    try {
+      flush();
+    } catch (...) {
+    }
+
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+    }
+
+    wakeup_.notify_all();
+    thread_.join();
+  }
+
+  bulk_writer(const bulk_writer&) = delete;
+  bulk_writer& operator=(const bulk_writer&) = delete;
+
+  void push(T row)
+  {
+    std::unique_lock lock(mutex_);
+    rethrow();
+
+    if (filling_.size() >= options_.batch_rows) {
+      hand_over(lock);
+    }
+
+    filling_.push_back(std::move(row));
+  }
+
+  // Blocks until every row pushed so far is committed.
+  void flush()
+  {
+    std::unique_lock lock(mutex_);
+    rethrow();
+
+    if (!filling_.empty()) {
+      hand_over(lock);
+    }
+
+    wakeup_.wait(lock, [this] { return committing_.empty() || error_; });
+    rethrow();
+  }
+
+  // Rows pushed but not committed yet.
+  size_t pending() const
+  {
+    std::lock_guard lock(mutex_);
+    return filling_.size() + committing_.size();
+  }
+
+  fl::bulk_writer_stats stats() const
+  {
+    std::lock_guard lock(mutex_);
+    auto result = stats_;
+    result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start_)
+                       .count();
+    return result;
+  }
+
+protected:
+  using clock = std::chrono::steady_clock;
+
+  void rethrow()
+  {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  // Moves the filled buffer to the commit thread, waiting for it to be
+  // done with the previous one first.
+  void hand_over(std::unique_lock<std::mutex>& lock)
+  {
+    if (!committing_.empty()) {
+      auto before = clock::now();
+
+      wakeup_.wait(lock, [this] { return committing_.empty() || error_; });
+
+      stats_.waits++;
+      stats_.wait_seconds +=
+        std::chrono::duration<double>(clock::now() - before).count();
+
+      rethrow();
+    }
+
+    std::swap(filling_, committing_);
+    wakeup_.notify_all();
+  }
+
+  template<typename F>
+  void bind_field(int const col, const F& value)
+  {
+    if constexpr (fl::detail::is_optional<F>::value) {
+      if (value) {
+        bind_field(col, *value);
+      } else {
+        insert_stmt_.bind(col, nullptr);
+      }
+    } else {
+      insert_stmt_.bind(col, value);
+    }
+  }
+
+  template<typename F>
+  static size_t field_bytes(const F& value)
+  {
+    if constexpr (fl::detail::is_optional<F>::value) {
+      return value ? field_bytes(*value) : 0;
+    } else {
+      return fl::detail::bound_bytes(value);
+    }
+  }
+
+  // Runs without the lock, `committing_` belongs to this thread until it
+  // is cleared.
+  size_t insert_batch()
+  {
+    // NOTE: a single chunk, the savepoint is the batch's transaction.
+    fl::bulk_transaction transaction(db_.ptr().get(),
+                                     { .chunk_rows = 0, .chunk_bytes = 0 });
+
+    auto borrowed = insert_stmt_.borrow();
+    size_t bytes = 0;
+
+    for (auto&& row : committing_) {
+      insert_stmt_.reset();
+
+      boost::pfr::for_each_field(row, [&](const auto& field, size_t ix) {
+        bind_field(int(ix + 1), field);
+        bytes += field_bytes(field);
+      });
+
+      insert_stmt_.execute();
+    }
+
+    insert_stmt_.reset();
+    transaction.commit();
+
+    return bytes;
+  }
+
+  void run()
+  {
+    std::unique_lock lock(mutex_);
+
+    for (;;) {
+      wakeup_.wait(lock, [this] { return stopping_ || !committing_.empty(); });
+
+      if (committing_.empty()) {
+        return;
+      }
+
+      lock.unlock();
+
+      auto before = clock::now();
+      std::exception_ptr error;
+      size_t bytes = 0;
+
+      try {
+        bytes = insert_batch();
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      auto seconds =
+        std::chrono::duration<double>(clock::now() - before).count();
+
+      lock.lock();
+
+      if (error) {
+        error_ = error;
+        filling_.clear();
+      } else {
+        stats_.rows += committing_.size();
+        stats_.batches++;
+        stats_.bytes += bytes;
+      }
+
+      stats_.commit_seconds += seconds;
+      committing_.clear();
+      wakeup_.notify_all();
+    }
+  }
+
+  fl::db db_;
+  fl::bulk_writer_options options_;
+  fl::stmt insert_stmt_;
+  clock::time_point start_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::vector<T> filling_;
+  std::vector<T> committing_;
+  fl::bulk_writer_stats stats_;
+  std::exception_ptr error_;
+  bool stopping_ = false;
+
+  // NOTE: Started last, in the constructor body.
+  std::thread thread_;
+};
+
+}
+
+#endif
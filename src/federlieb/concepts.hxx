@@ -2,11 +2,25 @@
 #define FEDERLIEB_CONCEPTS_HXX
 
 #include <concepts>
+#include <ranges>
+#include <type_traits>
+
+namespace federlieb {
+class context;
+}
 
 namespace federlieb::concepts {
 
 namespace fl = ::federlieb;
 
+// A row of an xFilter result: values by column index, a row of a
+// `fl::vtab::columns` result, or an aggregate with a field per column.
+template<typename Row>
+concept VirtualTableRow =
+  std::ranges::random_access_range<Row> ||
+  requires(const Row& row, fl::context& context) { row.result(context, 0); } ||
+  std::is_aggregate_v<std::remove_cvref_t<Row>>;
+
 template<typename Vtab>
 concept VirtualTable = requires(Vtab vtab,
                                 typename Vtab::cursor c,
@@ -19,7 +33,7 @@ concept VirtualTable = requires(Vtab vtab,
     } -> std::ranges::input_range;
   {
     *vtab.xFilter({}, cursor).begin()
-    } -> std::ranges::random_access_range;
+    } -> VirtualTableRow;
 };
 
 }
@@ -134,6 +134,48 @@ fl::context::result(const fl::value::variant& variant)
   std::visit([this](auto&& value) { result(value); }, variant);
 }
 
+void
+fl::context::result_static(const std::string& value)
+{
+  fl::api(sqlite3_result_text64,
+          db_,
+          ctx_,
+          value.c_str(),
+          fl::detail::safe_to<sqlite_int64>(value.size()),
+          SQLITE_STATIC,
+          SQLITE_UTF8);
+}
+
+void
+fl::context::result_static(const fl::value::text& v)
+{
+  result_static(v.value);
+}
+
+void
+fl::context::result_static(const fl::value::blob& v)
+{
+  fl::api(sqlite3_result_blob64,
+          db_,
+          ctx_,
+          v.value.data(),
+          fl::detail::safe_to<sqlite_int64>(v.value.size()),
+          SQLITE_STATIC);
+}
+
+void
+fl::context::result_static(const fl::value::json& v)
+{
+  result_static(v.value);
+  fl::api(sqlite3_result_subtype, db_, ctx_, 'J');
+}
+
+void
+fl::context::result_static(const fl::value::variant& variant)
+{
+  std::visit([this](auto&& value) { result_static(value); }, variant);
+}
+
 void
 fl::context::result(const fl::field& field)
 {
@@ -60,6 +60,21 @@ public:
     }
   }
 
+  // Like `result`, but TEXT and BLOB values are not copied, SQLite may
+  // use them until the statement is reset, so they must not change or go
+  // away before that.
+  void result_static(const std::string& value);
+  void result_static(const fl::value::text& v);
+  void result_static(const fl::value::blob& v);
+  void result_static(const fl::value::json& v);
+  void result_static(const fl::value::variant& variant);
+
+  template<typename T>
+  inline void result_static(const T& v)
+  {
+    result(v);
+  }
+
   void error(int code) noexcept;
   void error(const std::string& message) noexcept;
   void error_toobig() noexcept;
@@ -7,12 +7,29 @@ fl::db::open(std::string const location, int const flags, std::string const vfs)
 {
   sqlite3* db = nullptr;
 
+#if defined(FEDERLIEB_IO_URING)
+  if (vfs == fl::io_uring_vfs::name) {
+    fl::io_uring_vfs::register_vfs();
+  }
+#endif
+
+  int threading_flags = 0;
+
+  if (0 == (flags & (SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_FULLMUTEX))) {
+    if constexpr (fl::default_threading == fl::threading::single_thread) {
+      threading_flags = SQLITE_OPEN_NOMUTEX;
+    } else if constexpr (fl::default_threading ==
+                         fl::threading::serialized_by_sqlite) {
+      threading_flags = SQLITE_OPEN_FULLMUTEX;
+    }
+  }
+
   fl::api(sqlite3_open_v2,
           { SQLITE_OK },
           db,
           location.c_str(),
           &db,
-          flags,
+          flags | threading_flags,
           vfs.empty() ? nullptr : vfs.c_str());
 
   fl::error::raise_if(nullptr == db, "sqlite3_open_v2 returned a nullptr db");
@@ -22,11 +39,17 @@ fl::db::open(std::string const location, int const flags, std::string const vfs)
     int rc = sqlite3_close_v2(db);
     fl::error::raise_if(SQLITE_OK != rc, "error closing db");
   });
+
+  stmt_cache_ = std::make_shared<fl::stmt_cache>();
 }
 
 fl::stmt
 fl::db::prepare(const std::string_view sql)
 {
+  if (stmt_cache_) {
+    return fl::stmt(db_, stmt_cache_->lease(db_.get(), sql));
+  }
+
   sqlite3_stmt* stmt = nullptr;
 
   fl::api(sqlite3_prepare_v2,
@@ -100,3 +123,19 @@ fl::db::register_module(const std::string& name, const sqlite3_module* const p)
           p,
           nullptr);
 }
+
+std::shared_ptr<fl::stmt_profiler>
+fl::db::profile()
+{
+  return fl::stmt_profiler::install(db_.get());
+}
+
+fl::blob_stream
+fl::db::open_blob(const std::string& table,
+                  const std::string& column,
+                  sqlite3_int64 const rowid,
+                  bool const writable,
+                  const std::string& schema)
+{
+  return fl::blob_stream(db_, schema, table, column, rowid, writable);
+}
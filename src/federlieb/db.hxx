@@ -5,20 +5,32 @@
 
 #include "api.hxx"
 
+#include "federlieb/blob_stream.hxx"
 #include "federlieb/stmt.hxx"
+// NOTE: as.hxx has to follow stmt.hxx.
+#include "federlieb/as.hxx"
+#include "federlieb/stmt_cache.hxx"
 #include "federlieb/value.hxx"
 
 namespace federlieb {
 
 namespace fl = ::federlieb;
 
+class stmt_profiler;
+
 class db
 {
 public:
   db(){};
 
-  db(std::shared_ptr<sqlite3> db)
-    : db_(db){};
+  // Wraps a connection owned elsewhere. Statements come from `stmt_cache`
+  // when given, otherwise they are prepared each time. Cached statements
+  // keep the tables they read (virtual ones included) in use, so whoever
+  // passes a cache has to `clear()` it before the connection closes.
+  db(std::shared_ptr<sqlite3> db,
+     std::shared_ptr<fl::stmt_cache> stmt_cache = nullptr)
+    : db_(db)
+    , stmt_cache_(stmt_cache){};
 
   template<typename... Args>
   db(Args... args)
@@ -36,12 +48,51 @@ public:
 
   fl::value::variant select_scalar(const std::string sql);
 
+  // Runs `sql`, a complete query, with `params` bound by position and
+  // decodes the first column of the first row into `T`. When there is a
+  // statement cache, the statement comes from it, so calling this in a
+  // loop does not prepare `sql` again. Use `std::optional<T>` when the
+  // value can be NULL.
+  template<typename T, typename... Args>
+  T select_scalar(const std::string_view sql, const Args&... params)
+  {
+    auto stmt = prepare(sql);
+
+    // NOTE: not `execute(params...)`, a single string would be a range.
+    int ix = 1;
+    (stmt.bind(ix++, params), ...);
+    stmt.execute();
+
+    fl::error::raise_if(stmt.begin() == stmt.end(), "no result");
+    fl::error::raise_if(stmt.column_count() < 1, "no column");
+
+    T result;
+    fl::detail::extract(db_.get(), stmt.ptr().get(), 0, result);
+    return result;
+  }
+
   void register_module(const std::string& name, const sqlite3_module* const p);
 
+  fl::blob_stream open_blob(const std::string& table,
+                            const std::string& column,
+                            sqlite3_int64 const rowid,
+                            bool const writable = false,
+                            const std::string& schema = "main");
+
   std::shared_ptr<sqlite3> ptr() { return db_; }
 
+  // Starts collecting per-statement statistics on this connection, see
+  // `fl::stmt_profiler`. Calling this again returns the same profiler.
+  std::shared_ptr<fl::stmt_profiler> profile();
+
+  // Shared by all copies of this object, not by other `fl::db` objects
+  // wrapping the same connection. Set by `open`, or by the caller when
+  // wrapping a connection owned elsewhere.
+  std::shared_ptr<fl::stmt_cache> stmt_cache() const { return stmt_cache_; }
+
 protected:
   std::shared_ptr<sqlite3> db_ = nullptr;
+  std::shared_ptr<fl::stmt_cache> stmt_cache_ = nullptr;
 };
 
 }
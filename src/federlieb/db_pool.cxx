@@ -0,0 +1,171 @@
+#include "federlieb/federlieb.hxx"
+
+#include <chrono>
+
+namespace fl = ::federlieb;
+
+fl::db_pool::db_pool(std::string const location,
+                     size_t const readers,
+                     setup_function setup,
+                     std::string const vfs)
+{
+  fl::error::raise_if(location.empty() || location == ":memory:",
+                      "db_pool needs a database file");
+
+  fl::error::raise_if(0 == readers, "db_pool needs at least one reader");
+
+  // NOTE: Every connection is used by one thread at a time, so SQLite
+  // need not serialize access itself.
+  auto open = [&](fl::db_pool::group& group, int const flags) {
+    auto slot = std::make_unique<fl::db_pool::lease::slot>();
+    slot->db.open(location, flags | SQLITE_OPEN_NOMUTEX, vfs);
+    slot->group = &group;
+
+    if (setup) {
+      setup(slot->db);
+    }
+
+    group.slots.push_back(std::move(slot));
+  };
+
+  // The writer comes first so the file exists and is in WAL mode before
+  // any reader opens it.
+  open(writer_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+
+  auto journal_mode =
+    writer_.slots.front()->db.prepare("PRAGMA journal_mode = WAL");
+
+  journal_mode.execute();
+
+  fl::error::raise_if(journal_mode.current_row().at(0).to_text() != "wal",
+                      "db_pool could not enable WAL mode");
+
+  for (size_t ix = 0; ix < readers; ++ix) {
+    open(readers_, SQLITE_OPEN_READONLY);
+  }
+}
+
+fl::db_pool::lease
+fl::db_pool::read()
+{
+  return acquire(readers_);
+}
+
+fl::db_pool::lease
+fl::db_pool::write()
+{
+  return acquire(writer_);
+}
+
+fl::db_pool::lease
+fl::db_pool::acquire(group& group)
+{
+  auto count = group.slots.size();
+  auto start = std::chrono::steady_clock::time_point();
+  bool waited = false;
+
+  for (;;) {
+    auto released = group.released.load(std::memory_order_acquire);
+    auto hint = group.hint.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t ix = 0; ix < count; ++ix) {
+      auto& slot = group.slots[(hint + ix) % count];
+      bool expected = false;
+
+      if (!slot->busy.compare_exchange_strong(
+            expected, true, std::memory_order_acquire)) {
+        continue;
+      }
+
+      leases_.fetch_add(1, std::memory_order_relaxed);
+
+      if (!waited) {
+        return lease(slot.get(), 0);
+      }
+
+      uint64_t nanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+
+      waits_.fetch_add(1, std::memory_order_relaxed);
+      wait_nanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+      auto max = max_wait_nanoseconds_.load(std::memory_order_relaxed);
+      while (max < nanoseconds &&
+             !max_wait_nanoseconds_.compare_exchange_weak(
+               max, nanoseconds, std::memory_order_relaxed)) {
+      }
+
+      return lease(slot.get(), nanoseconds / 1e9);
+    }
+
+    if (!waited) {
+      waited = true;
+      start = std::chrono::steady_clock::now();
+    }
+
+    group.released.wait(released, std::memory_order_acquire);
+  }
+}
+
+fl::db_pool::statistics
+fl::db_pool::stats() const
+{
+  return {
+    .leases = leases_.load(std::memory_order_relaxed),
+    .waits = waits_.load(std::memory_order_relaxed),
+    .wait_seconds = wait_nanoseconds_.load(std::memory_order_relaxed) / 1e9,
+    .max_wait_seconds =
+      max_wait_nanoseconds_.load(std::memory_order_relaxed) / 1e9,
+  };
+}
+
+fl::db_pool::lease::lease(lease&& other) noexcept
+  : slot_(std::exchange(other.slot_, nullptr))
+  , wait_seconds_(other.wait_seconds_)
+{}
+
+fl::db_pool::lease&
+fl::db_pool::lease::operator=(lease&& other) noexcept
+{
+  if (this != &other) {
+    release();
+    slot_ = std::exchange(other.slot_, nullptr);
+    wait_seconds_ = other.wait_seconds_;
+  }
+
+  return *this;
+}
+
+fl::db_pool::lease::~lease()
+{
+  release();
+}
+
+void
+fl::db_pool::lease::release() noexcept
+{
+  if (nullptr == slot_) {
+    return;
+  }
+
+  slot_->busy.store(false, std::memory_order_release);
+  slot_->group->released.fetch_add(1, std::memory_order_release);
+  slot_->group->released.notify_one();
+
+  slot_ = nullptr;
+}
+
+fl::db&
+fl::db_pool::lease::operator*() const
+{
+  fl::error::raise_if(nullptr == slot_, "lease was moved from");
+  return slot_->db;
+}
+
+fl::db*
+fl::db_pool::lease::operator->() const
+{
+  return &**this;
+}
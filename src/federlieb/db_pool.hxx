@@ -0,0 +1,113 @@
+#ifndef FEDERLIEB_DB_POOL_HXX
+#define FEDERLIEB_DB_POOL_HXX
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api.hxx"
+
+#include "federlieb/db.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+// A fixed set of connections to one database file in WAL mode: `readers`
+// read-only connections and a single writer, so readers do not serialize
+// on one connection and do not block the writer. `setup` is applied to
+// every connection after opening, typically to register modules and
+// functions. Leases are handed out and returned with atomic operations;
+// when all connections are leased, `read()` and `write()` block until one
+// is returned. Leases must not outlive the pool.
+class db_pool
+{
+public:
+  using setup_function = std::function<void(fl::db&)>;
+
+  struct statistics
+  {
+    uint64_t leases = 0;
+    uint64_t waits = 0;
+    double wait_seconds = 0;
+    double max_wait_seconds = 0;
+  };
+
+  class lease
+  {
+  public:
+    lease(lease&& other) noexcept;
+    lease& operator=(lease&& other) noexcept;
+    ~lease();
+
+    lease(const lease&) = delete;
+    lease& operator=(const lease&) = delete;
+
+    fl::db& operator*() const;
+    fl::db* operator->() const;
+
+    // How long `read()` or `write()` waited for this connection.
+    double wait_seconds() const { return wait_seconds_; }
+
+  protected:
+    friend class fl::db_pool;
+
+    struct slot;
+
+    lease(fl::db_pool::lease::slot* slot, double wait_seconds)
+      : slot_(slot)
+      , wait_seconds_(wait_seconds)
+    {}
+
+    void release() noexcept;
+
+    slot* slot_ = nullptr;
+    double wait_seconds_ = 0;
+  };
+
+  db_pool(std::string const location,
+          size_t const readers,
+          setup_function setup = {},
+          std::string const vfs = {});
+
+  db_pool(const db_pool&) = delete;
+  db_pool& operator=(const db_pool&) = delete;
+
+  lease read();
+  lease write();
+
+  size_t readers() const { return readers_.slots.size(); }
+
+  fl::db_pool::statistics stats() const;
+
+protected:
+  struct group
+  {
+    std::vector<std::unique_ptr<fl::db_pool::lease::slot>> slots;
+    std::atomic<uint32_t> released = 0;
+    std::atomic<uint32_t> hint = 0;
+  };
+
+  lease acquire(group& group);
+
+  group readers_;
+  group writer_;
+
+  std::atomic<uint64_t> leases_ = 0;
+  std::atomic<uint64_t> waits_ = 0;
+  std::atomic<uint64_t> wait_nanoseconds_ = 0;
+  std::atomic<uint64_t> max_wait_nanoseconds_ = 0;
+};
+
+struct db_pool::lease::slot
+{
+  fl::db db;
+  std::atomic<bool> busy = false;
+  fl::db_pool::group* group = nullptr;
+};
+
+}
+
+#endif
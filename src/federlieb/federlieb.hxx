@@ -15,13 +15,23 @@
 #include "error.hxx"
 #include "value.hxx"
 
+#include "batch.hxx"
+#include "blob_stream.hxx"
+#include "bulk.hxx"
 #include "column.hxx"
 #include "db.hxx"
+#include "db_pool.hxx"
 #include "field.hxx"
+#include "io_uring_vfs.hxx"
 #include "row.hxx"
+#include "script.hxx"
 #include "stmt.hxx"
+#include "stmt_cache.hxx"
+#include "stmt_profiler.hxx"
+#include "worker.hxx"
 
 #include "as.hxx"
+#include "bulk_writer.hxx"
 #include "pragma.hxx"
 
 #include "context.hxx"
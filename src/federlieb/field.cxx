@@ -13,6 +13,12 @@ fl::field::type() const
   return fl::api(sqlite3_column_type, db(), row_.stmt_->stmt_.get(), index_);
 }
 
+int
+fl::field::bytes() const
+{
+  return fl::api(sqlite3_column_bytes, db(), row_.stmt_->stmt_.get(), index_);
+}
+
 std::string
 fl::field::name() const
 {
@@ -116,3 +122,32 @@ fl::field::unprotected_value() const
 {
   return fl::api(sqlite3_column_value, db(), row_.stmt_->stmt_.get(), index_);
 }
+
+fl::value::view
+fl::field::to_view() const
+{
+  auto stmt = row_.stmt_->stmt_.get();
+
+  switch (type()) {
+    case SQLITE_INTEGER:
+      return fl::value::integer{ to_integer() };
+    case SQLITE_FLOAT:
+      return fl::value::real{ to_float() };
+    case SQLITE_TEXT: {
+      auto data =
+        (const char*)fl::api(sqlite3_column_text, db(), stmt, index_);
+      auto length = fl::api(sqlite3_column_bytes, db(), stmt, index_);
+      return fl::value::text_view{ std::string_view(data, length) };
+    }
+    case SQLITE_BLOB: {
+      auto data = static_cast<const std::byte*>(
+        fl::api(sqlite3_column_blob, db(), stmt, index_));
+      auto length = fl::api(sqlite3_column_bytes, db(), stmt, index_);
+      return fl::value::blob_view{ std::span<const std::byte>(data, length) };
+    }
+    case SQLITE_NULL:
+      return fl::value::null{};
+    default:
+      fl::error::raise("unknown type");
+  }
+}
@@ -17,6 +17,7 @@ public:
   int index() const { return index_; }
   std::string name() const;
   int type() const;
+  int bytes() const;
   bool is_null() const { return type() == SQLITE_NULL; }
   bool is_text() const { return type() == SQLITE_TEXT; }
   bool is_blob() const { return type() == SQLITE_BLOB; }
@@ -57,6 +58,8 @@ public:
   }
 
   fl::value::variant to_variant() const;
+  // Like `to_variant`, but valid only until the statement moves on.
+  fl::value::view to_view() const;
   sqlite3_int64 to_integer() const;
   std::string to_text() const;
   double to_float() const;
@@ -0,0 +1,1022 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+namespace {
+
+struct
+{
+  std::atomic<uint64_t> submits = 0;
+  std::atomic<uint64_t> reads = 0;
+  std::atomic<uint64_t> writes = 0;
+  std::atomic<uint64_t> syncs = 0;
+  std::atomic<uint64_t> batched_writes = 0;
+  std::atomic<uint64_t> readahead_hits = 0;
+} counters;
+
+fl::io_uring_vfs::options vfs_options;
+
+// The parts of io_uring needed here, on the raw system calls, see
+// https://kernel.dk/io_uring.pdf; this does not need liburing.
+class ring
+{
+public:
+  struct request
+  {
+    uint8_t opcode = IORING_OP_NOP;
+    void* buffer = nullptr;
+    uint32_t length = 0;
+    uint64_t offset = 0;
+    uint32_t fsync_flags = 0;
+    int result = 0;
+  };
+
+  explicit ring(unsigned const entries)
+  {
+    io_uring_params params{};
+
+    fd_ = int(syscall(__NR_io_uring_setup, entries, &params));
+
+    if (fd_ < 0) {
+      return;
+    }
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+
+    if (single) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+
+    sq_ = map(sq_size_, IORING_OFF_SQ_RING);
+    cq_ = single ? sq_ : map(cq_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+
+    if (nullptr == sq_ || nullptr == cq_ || nullptr == sqes_) {
+      release();
+      return;
+    }
+
+    auto sq = static_cast<char*>(sq_);
+    auto cq = static_cast<char*>(cq_);
+
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    entries_ = params.sq_entries;
+  }
+
+  ~ring() { release(); }
+
+  ring(const ring&) = delete;
+  ring& operator=(const ring&) = delete;
+
+  bool ok() const { return fd_ >= 0; }
+
+  // Submits all requests against `fd` and waits for all of them, in
+  // groups of at most the queue depth. Results are those of the system
+  // call, negative `errno` values on failure.
+  void run(int const fd, std::span<request> requests)
+  {
+    for (auto&& req : requests) {
+      req.result = -EIO;
+    }
+
+    while (ok() && !requests.empty()) {
+      auto group = requests.first(std::min<size_t>(requests.size(), entries_));
+
+      unsigned tail = *sq_tail_;
+
+      for (size_t ix = 0; ix < group.size(); ++ix) {
+        auto index = (tail + ix) & sq_mask_;
+        auto& sqe = sqes_[index];
+
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = group[ix].opcode;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(group[ix].buffer);
+        sqe.len = group[ix].length;
+        sqe.off = group[ix].offset;
+        sqe.fsync_flags = group[ix].fsync_flags;
+        sqe.user_data = ix;
+        sq_array_[index] = index;
+      }
+
+      __atomic_store_n(
+        sq_tail_, tail + unsigned(group.size()), __ATOMIC_RELEASE);
+
+      enter(group);
+
+      requests = requests.subspan(group.size());
+    }
+  }
+
+protected:
+  void* map(size_t const size, off_t const offset)
+  {
+    auto ptr = mmap(nullptr,
+                    size,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE,
+                    fd_,
+                    offset);
+
+    return MAP_FAILED == ptr ? nullptr : ptr;
+  }
+
+  // Submits the queued entries of `group` and reaps as many completions.
+  void enter(std::span<request> group)
+  {
+    unsigned const count = unsigned(group.size());
+    unsigned submitted = 0;
+    unsigned completed = 0;
+
+    counters.submits++;
+
+    while (completed < count) {
+      int rc = int(syscall(__NR_io_uring_enter,
+                           fd_,
+                           count - submitted,
+                           count - completed,
+                           IORING_ENTER_GETEVENTS,
+                           nullptr,
+                           0));
+
+      if (rc < 0 && EINTR != errno && EAGAIN != errno && EBUSY != errno) {
+        // NOTE: entries not consumed by the kernel would be submitted
+        // with the next group, so the ring cannot be used any more.
+        release();
+        return;
+      }
+
+      submitted += std::max(rc, 0);
+      completed += reap(group);
+    }
+  }
+
+  unsigned reap(std::span<request> group)
+  {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    unsigned count = 0;
+
+    for (; head != tail; ++head, ++count) {
+      auto& cqe = cqes_[head & cq_mask_];
+      group[cqe.user_data].result = cqe.res;
+    }
+
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+    return count;
+  }
+
+  void release()
+  {
+    if (sqes_) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ && cq_ != sq_) {
+      munmap(cq_, cq_size_);
+    }
+    if (sq_) {
+      munmap(sq_, sq_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    fd_ = -1;
+    sq_ = cq_ = nullptr;
+    sqes_ = nullptr;
+  }
+
+  int fd_ = -1;
+  unsigned entries_ = 0;
+
+  void* sq_ = nullptr;
+  void* cq_ = nullptr;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sq_size_ = 0;
+  size_t cq_size_ = 0;
+  size_t sqes_size_ = 0;
+
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+};
+
+// Descriptors shared by all handles on the same file, see the note on
+// POSIX locks in the header.
+class descriptors
+{
+public:
+  int acquire(const char* path, bool const writable)
+  {
+    struct stat st;
+
+    if (0 != stat(path, &st)) {
+      return -1;
+    }
+
+    std::lock_guard lock(mutex_);
+
+    auto&& entry = open_[{ st.st_dev, st.st_ino }];
+
+    if (entry.fd < 0) {
+      entry.fd = open(path, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+      entry.writable = writable;
+    }
+
+    if (entry.fd < 0 || (writable && !entry.writable)) {
+      if (0 == entry.references) {
+        open_.erase({ st.st_dev, st.st_ino });
+      }
+      return -1;
+    }
+
+    entry.references++;
+    return entry.fd;
+  }
+
+  void release(int const fd)
+  {
+    std::lock_guard lock(mutex_);
+
+    auto it = std::ranges::find_if(
+      open_, [fd](auto&& e) { return e.second.fd == fd; });
+
+    if (it != open_.end() && 0 == --it->second.references) {
+      close(fd);
+      open_.erase(it);
+    }
+  }
+
+protected:
+  struct entry
+  {
+    int fd = -1;
+    bool writable = false;
+    size_t references = 0;
+  };
+
+  std::mutex mutex_;
+  std::map<std::pair<dev_t, ino_t>, entry> open_;
+};
+
+descriptors shared_descriptors;
+
+struct file_state
+{
+  int flags = 0;
+  int fd = -1;
+  std::optional<ring> io;
+  bool synced_once = false;
+  // The file of the wrapped VFS.
+  sqlite3_file* real = nullptr;
+  // The first failure of a queued write. Such writes were reported as
+  // done already, so it is returned by every later operation instead.
+  int error = SQLITE_OK;
+
+  // Main database files, for read-ahead.
+  std::vector<char> readahead;
+  sqlite3_int64 readahead_offset = 0;
+  size_t readahead_size = 0;
+  sqlite3_int64 next_offset = -1;
+  unsigned sequential = 0;
+
+  // WAL files, queued writes with their data in `arena`.
+  struct pending_write
+  {
+    sqlite3_int64 offset;
+    size_t position;
+    size_t size;
+  };
+  std::vector<pending_write> pending;
+  std::vector<char> arena;
+  // Whether the last write was the header of a commit frame.
+  bool commit_header = false;
+  std::vector<ring::request> requests;
+
+  // The WAL of a database file of the same connection and vice versa.
+  file_state* wal = nullptr;
+  file_state* main = nullptr;
+  const char* key = nullptr;
+
+  bool is_wal() const { return flags & SQLITE_OPEN_WAL; }
+  bool is_main() const { return flags & SQLITE_OPEN_MAIN_DB; }
+};
+
+// Database files by the name pointer SQLite passes to `xOpen`, which is
+// what `sqlite3_filename_database` returns for the WAL file name.
+std::mutex main_files_mutex;
+std::map<const char*, file_state*> main_files;
+
+struct uring_file
+{
+  sqlite3_file base;
+  file_state* state;
+  sqlite3_file* real;
+};
+
+sqlite3_vfs*
+wrapped(sqlite3_vfs* vfs)
+{
+  return static_cast<sqlite3_vfs*>(vfs->pAppData);
+}
+
+uring_file*
+unbox(sqlite3_file* file)
+{
+  return reinterpret_cast<uring_file*>(file);
+}
+
+sqlite3_file*
+real(sqlite3_file* file)
+{
+  return unbox(file)->real;
+}
+
+// Once `ring::enter` fails, the ring is released and the file goes on
+// through the wrapped VFS.
+bool
+uses_ring(const file_state* state)
+{
+  return state->fd >= 0 && state->io->ok();
+}
+
+int
+error_code(int const result, int const fallback)
+{
+  return -ENOSPC == result ? SQLITE_FULL : fallback;
+}
+
+// Writes the rest of a short write the ordinary way.
+bool
+complete_write(int const fd, const char* data, size_t size, off_t offset)
+{
+  while (size > 0) {
+    auto written = pwrite(fd, data, size, offset);
+
+    if (written < 0 && EINTR == errno) {
+      continue;
+    } else if (written <= 0) {
+      return false;
+    }
+
+    data += written;
+    size -= written;
+    offset += written;
+  }
+
+  return true;
+}
+
+int
+flush(file_state* state)
+{
+  if (nullptr == state) {
+    return SQLITE_OK;
+  }
+
+  if (SQLITE_OK != state->error || state->pending.empty()) {
+    return state->error;
+  }
+
+  int rc = SQLITE_OK;
+
+  if (uses_ring(state)) {
+    auto& requests = state->requests;
+    requests.clear();
+
+    for (auto&& write : state->pending) {
+      requests.push_back({ .opcode = IORING_OP_WRITE,
+                           .buffer = state->arena.data() + write.position,
+                           .length = uint32_t(write.size),
+                           .offset = uint64_t(write.offset) });
+    }
+
+    state->io->run(state->fd, requests);
+
+    counters.writes += requests.size();
+    counters.batched_writes += requests.size();
+
+    for (size_t ix = 0; ix < requests.size() && uses_ring(state); ++ix) {
+      auto&& req = requests[ix];
+      auto&& write = state->pending[ix];
+      auto data = state->arena.data() + write.position;
+
+      if (req.result < 0) {
+        rc = error_code(req.result, SQLITE_IOERR_WRITE);
+      } else if (size_t(req.result) < write.size &&
+                 !complete_write(state->fd,
+                                 data + req.result,
+                                 write.size - req.result,
+                                 write.offset + req.result)) {
+        rc = SQLITE_IOERR_WRITE;
+      }
+    }
+  }
+
+  // NOTE: the ring failed now or earlier, which leaves no way to tell
+  // which writes made it, so all of them are written again.
+  if (!uses_ring(state)) {
+    rc = SQLITE_OK;
+
+    for (auto&& write : state->pending) {
+      rc = state->real->pMethods->xWrite(state->real,
+                                         state->arena.data() + write.position,
+                                         int(write.size),
+                                         write.offset);
+
+      if (SQLITE_OK != rc) {
+        break;
+      }
+    }
+  }
+
+  state->pending.clear();
+  state->arena.clear();
+  state->error = rc;
+
+  return rc;
+}
+
+void
+drop_readahead(file_state* state)
+{
+  state->readahead_size = 0;
+  state->sequential = 0;
+  state->next_offset = -1;
+}
+
+int
+read_into(file_state* state, void* buffer, int const amount, sqlite3_int64 offset)
+{
+  ring::request req{ .opcode = IORING_OP_READ,
+                     .buffer = buffer,
+                     .length = uint32_t(amount),
+                     .offset = uint64_t(offset) };
+
+  state->io->run(state->fd, std::span(&req, 1));
+  counters.reads++;
+
+  return req.result;
+}
+
+int
+x_close(sqlite3_file* file)
+{
+  auto state = unbox(file)->state;
+  int rc = flush(state);
+
+  {
+    std::lock_guard lock(main_files_mutex);
+
+    if (state->key) {
+      main_files.erase(state->key);
+    }
+    if (state->wal) {
+      state->wal->main = nullptr;
+    }
+    if (state->main) {
+      state->main->wal = nullptr;
+    }
+  }
+
+  auto inner = real(file);
+  int inner_rc = inner->pMethods->xClose(inner);
+
+  if (state->fd >= 0) {
+    shared_descriptors.release(state->fd);
+  }
+
+  delete state;
+
+  return SQLITE_OK != rc ? rc : inner_rc;
+}
+
+int
+x_read(sqlite3_file* file, void* buffer, int amount, sqlite3_int64 offset)
+{
+  auto state = unbox(file)->state;
+
+  if (int rc = flush(state); SQLITE_OK != rc) {
+    return rc;
+  }
+
+  if (!uses_ring(state)) {
+    return real(file)->pMethods->xRead(real(file), buffer, amount, offset);
+  }
+
+  bool sequential = offset == state->next_offset;
+  state->sequential = sequential ? state->sequential + 1 : 0;
+  state->next_offset = offset + amount;
+
+  auto ra_begin = state->readahead_offset;
+  auto ra_end = ra_begin + sqlite3_int64(state->readahead_size);
+
+  if (offset >= ra_begin && offset + amount <= ra_end) {
+    std::memcpy(buffer, state->readahead.data() + (offset - ra_begin), amount);
+    counters.readahead_hits++;
+    return SQLITE_OK;
+  }
+
+  int result = 0;
+  auto pages = vfs_options.readahead_pages;
+
+  if (state->is_main() && pages > 1 && state->sequential >= 2) {
+    state->readahead.resize(size_t(amount) * pages);
+    result =
+      read_into(state, state->readahead.data(), amount * pages, offset);
+    state->readahead_offset = offset;
+    state->readahead_size = std::max(result, 0);
+
+    if (result > 0) {
+      std::memcpy(buffer, state->readahead.data(), std::min(result, amount));
+    }
+  } else {
+    result = read_into(state, buffer, amount, offset);
+  }
+
+  if (!uses_ring(state)) {
+    drop_readahead(state);
+    return real(file)->pMethods->xRead(real(file), buffer, amount, offset);
+  }
+
+  if (result < 0) {
+    return SQLITE_IOERR_READ;
+  }
+
+  if (result < amount) {
+    std::memset(static_cast<char*>(buffer) + result, 0, amount - result);
+    return SQLITE_IOERR_SHORT_READ;
+  }
+
+  return SQLITE_OK;
+}
+
+int
+x_write(sqlite3_file* file,
+        const void* buffer,
+        int amount,
+        sqlite3_int64 offset)
+{
+  auto state = unbox(file)->state;
+
+  if (SQLITE_OK != state->error) {
+    return state->error;
+  }
+
+  if (!uses_ring(state)) {
+    if (int rc = flush(state); SQLITE_OK != rc) {
+      return rc;
+    }
+
+    return real(file)->pMethods->xWrite(real(file), buffer, amount, offset);
+  }
+
+  drop_readahead(state);
+
+  auto data = static_cast<const char*>(buffer);
+
+  if (state->is_wal()) {
+    // NOTE: queued writes complete in any order, so they must not overlap.
+    auto overlaps = std::ranges::any_of(state->pending, [&](auto&& write) {
+      return offset < write.offset + sqlite3_int64(write.size) &&
+             write.offset < offset + amount;
+    });
+
+    if (overlaps) {
+      if (int rc = flush(state); SQLITE_OK != rc) {
+        return rc;
+      }
+    }
+
+    state->pending.push_back({ offset, state->arena.size(), size_t(amount) });
+    state->arena.insert(state->arena.end(), data, data + amount);
+
+    // NOTE: frames are written as a 24 byte header, past the 32 byte WAL
+    // header, and then the page. Headers of commit frames carry the size
+    // of the database in bytes 4 to 7. Once the page of a commit frame is
+    // written SQLite takes the transaction as committed, so a failure has
+    // to be returned now, not at the barrier after it.
+    bool commit = state->commit_header;
+    state->commit_header = 24 == amount && offset >= 32 &&
+                           0 != (data[4] | data[5] | data[6] | data[7]);
+
+    if (commit || state->pending.size() >= vfs_options.wal_batch) {
+      return flush(state);
+    }
+
+    return SQLITE_OK;
+  }
+
+  ring::request req{ .opcode = IORING_OP_WRITE,
+                     .buffer = const_cast<char*>(data),
+                     .length = uint32_t(amount),
+                     .offset = uint64_t(offset) };
+
+  state->io->run(state->fd, std::span(&req, 1));
+  counters.writes++;
+
+  if (!uses_ring(state)) {
+    return real(file)->pMethods->xWrite(real(file), buffer, amount, offset);
+  }
+
+  if (req.result < 0) {
+    return error_code(req.result, SQLITE_IOERR_WRITE);
+  }
+
+  if (req.result < amount &&
+      !complete_write(
+        state->fd, data + req.result, amount - req.result, offset + req.result)) {
+    return SQLITE_IOERR_WRITE;
+  }
+
+  return SQLITE_OK;
+}
+
+int
+x_truncate(sqlite3_file* file, sqlite3_int64 size)
+{
+  auto state = unbox(file)->state;
+
+  if (int rc = flush(state); SQLITE_OK != rc) {
+    return rc;
+  }
+
+  drop_readahead(state);
+
+  return real(file)->pMethods->xTruncate(real(file), size);
+}
+
+int
+x_sync(sqlite3_file* file, int flags)
+{
+  auto state = unbox(file)->state;
+
+  if (int rc = flush(state); SQLITE_OK != rc) {
+    return rc;
+  }
+
+  // NOTE: the first sync goes through the wrapped VFS, which also syncs
+  // the directory of a newly created file.
+  if (!uses_ring(state) || !state->synced_once) {
+    state->synced_once = true;
+    return real(file)->pMethods->xSync(real(file), flags);
+  }
+
+  ring::request req{ .opcode = IORING_OP_FSYNC,
+                     .fsync_flags = (flags & SQLITE_SYNC_DATAONLY)
+                                      ? IORING_FSYNC_DATASYNC
+                                      : 0u };
+
+  state->io->run(state->fd, std::span(&req, 1));
+  counters.syncs++;
+
+  if (!uses_ring(state)) {
+    return real(file)->pMethods->xSync(real(file), flags);
+  }
+
+  return req.result < 0 ? SQLITE_IOERR_FSYNC : SQLITE_OK;
+}
+
+int
+x_file_size(sqlite3_file* file, sqlite3_int64* size)
+{
+  if (int rc = flush(unbox(file)->state); SQLITE_OK != rc) {
+    return rc;
+  }
+
+  return real(file)->pMethods->xFileSize(real(file), size);
+}
+
+int
+x_lock(sqlite3_file* file, int lock)
+{
+  drop_readahead(unbox(file)->state);
+  return real(file)->pMethods->xLock(real(file), lock);
+}
+
+int
+x_unlock(sqlite3_file* file, int lock)
+{
+  drop_readahead(unbox(file)->state);
+  return real(file)->pMethods->xUnlock(real(file), lock);
+}
+
+int
+x_check_reserved_lock(sqlite3_file* file, int* out)
+{
+  return real(file)->pMethods->xCheckReservedLock(real(file), out);
+}
+
+int
+x_file_control(sqlite3_file* file, int op, void* arg)
+{
+  if (int rc = flush(unbox(file)->state); SQLITE_OK != rc) {
+    return rc;
+  }
+
+  return real(file)->pMethods->xFileControl(real(file), op, arg);
+}
+
+int
+x_sector_size(sqlite3_file* file)
+{
+  return real(file)->pMethods->xSectorSize(real(file));
+}
+
+int
+x_device_characteristics(sqlite3_file* file)
+{
+  return real(file)->pMethods->xDeviceCharacteristics(real(file));
+}
+
+int
+x_shm_map(sqlite3_file* file, int page, int size, int extend, void volatile** p)
+{
+  return real(file)->pMethods->xShmMap(real(file), page, size, extend, p);
+}
+
+int
+x_shm_lock(sqlite3_file* file, int offset, int n, int flags)
+{
+  drop_readahead(unbox(file)->state);
+  return real(file)->pMethods->xShmLock(real(file), offset, n, flags);
+}
+
+void
+x_shm_barrier(sqlite3_file* file)
+{
+  // NOTE: the WAL index header is published right after this, so queued
+  // WAL frames have to be written now. Commits flush in `x_write` already.
+  // There is no way to fail here, a failed write is kept in the WAL's
+  // state and every later operation on the WAL returns it, so the
+  // connection cannot go on past frames that are missing.
+  flush(unbox(file)->state->wal);
+  real(file)->pMethods->xShmBarrier(real(file));
+}
+
+int
+x_shm_unmap(sqlite3_file* file, int delete_flag)
+{
+  return real(file)->pMethods->xShmUnmap(real(file), delete_flag);
+}
+
+int
+x_fetch(sqlite3_file* file, sqlite3_int64 offset, int amount, void** p)
+{
+  return real(file)->pMethods->xFetch(real(file), offset, amount, p);
+}
+
+int
+x_unfetch(sqlite3_file* file, sqlite3_int64 offset, void* p)
+{
+  return real(file)->pMethods->xUnfetch(real(file), offset, p);
+}
+
+const sqlite3_io_methods io_methods = {
+  3,
+  x_close,
+  x_read,
+  x_write,
+  x_truncate,
+  x_sync,
+  x_file_size,
+  x_lock,
+  x_unlock,
+  x_check_reserved_lock,
+  x_file_control,
+  x_sector_size,
+  x_device_characteristics,
+  x_shm_map,
+  x_shm_lock,
+  x_shm_barrier,
+  x_shm_unmap,
+  x_fetch,
+  x_unfetch,
+};
+
+constexpr size_t
+real_offset()
+{
+  return (sizeof(uring_file) + 15) & ~size_t(15);
+}
+
+int
+x_open(sqlite3_vfs* vfs,
+       const char* name,
+       sqlite3_file* file,
+       int flags,
+       int* out_flags)
+{
+  auto boxed = unbox(file);
+  boxed->base.pMethods = nullptr;
+  boxed->real = reinterpret_cast<sqlite3_file*>(
+    reinterpret_cast<char*>(file) + real_offset());
+
+  int rc = wrapped(vfs)->xOpen(wrapped(vfs), name, boxed->real, flags, out_flags);
+
+  if (SQLITE_OK != rc || nullptr == boxed->real->pMethods) {
+    return rc;
+  }
+
+  file_state* state = nullptr;
+  bool wanted = name && (flags & (SQLITE_OPEN_MAIN_DB | SQLITE_OPEN_WAL));
+
+  try {
+    state = new file_state();
+    state->flags = out_flags ? (*out_flags | (flags & ~7)) : flags;
+    state->real = boxed->real;
+
+    if (wanted) {
+      state->io.emplace(vfs_options.queue_depth);
+    }
+  } catch (...) {
+    delete state;
+    boxed->real->pMethods->xClose(boxed->real);
+    return SQLITE_NOMEM;
+  }
+
+  if (wanted && state->io->ok()) {
+    state->fd = shared_descriptors.acquire(
+      name, state->flags & SQLITE_OPEN_READWRITE);
+  }
+
+  if (wanted) {
+    std::lock_guard lock(main_files_mutex);
+
+    if (state->is_main()) {
+      state->key = name;
+      main_files[name] = state;
+    } else if (auto it = main_files.find(sqlite3_filename_database(name));
+               it != main_files.end()) {
+      state->main = it->second;
+      it->second->wal = state;
+    }
+  }
+
+  boxed->state = state;
+  boxed->base.pMethods = &io_methods;
+
+  return SQLITE_OK;
+}
+
+int
+x_delete(sqlite3_vfs* vfs, const char* name, int sync_dir)
+{
+  return wrapped(vfs)->xDelete(wrapped(vfs), name, sync_dir);
+}
+
+int
+x_access(sqlite3_vfs* vfs, const char* name, int flags, int* out)
+{
+  return wrapped(vfs)->xAccess(wrapped(vfs), name, flags, out);
+}
+
+int
+x_full_pathname(sqlite3_vfs* vfs, const char* name, int size, char* out)
+{
+  return wrapped(vfs)->xFullPathname(wrapped(vfs), name, size, out);
+}
+
+void*
+x_dl_open(sqlite3_vfs* vfs, const char* name)
+{
+  return wrapped(vfs)->xDlOpen(wrapped(vfs), name);
+}
+
+void
+x_dl_error(sqlite3_vfs* vfs, int size, char* out)
+{
+  wrapped(vfs)->xDlError(wrapped(vfs), size, out);
+}
+
+void (*x_dl_sym(sqlite3_vfs* vfs, void* handle, const char* symbol))(void)
+{
+  return wrapped(vfs)->xDlSym(wrapped(vfs), handle, symbol);
+}
+
+void
+x_dl_close(sqlite3_vfs* vfs, void* handle)
+{
+  wrapped(vfs)->xDlClose(wrapped(vfs), handle);
+}
+
+int
+x_randomness(sqlite3_vfs* vfs, int size, char* out)
+{
+  return wrapped(vfs)->xRandomness(wrapped(vfs), size, out);
+}
+
+int
+x_sleep(sqlite3_vfs* vfs, int microseconds)
+{
+  return wrapped(vfs)->xSleep(wrapped(vfs), microseconds);
+}
+
+int
+x_current_time(sqlite3_vfs* vfs, double* out)
+{
+  return wrapped(vfs)->xCurrentTime(wrapped(vfs), out);
+}
+
+int
+x_get_last_error(sqlite3_vfs* vfs, int size, char* out)
+{
+  return wrapped(vfs)->xGetLastError(wrapped(vfs), size, out);
+}
+
+int
+x_current_time_int64(sqlite3_vfs* vfs, sqlite3_int64* out)
+{
+  return wrapped(vfs)->xCurrentTimeInt64(wrapped(vfs), out);
+}
+
+sqlite3_vfs uring_vfs;
+std::once_flag registered;
+
+}
+
+void
+fl::io_uring_vfs::register_vfs()
+{
+  register_vfs(options{});
+}
+
+void
+fl::io_uring_vfs::register_vfs(const options& opts, bool const make_default)
+{
+  std::call_once(registered, [&] {
+    auto base = sqlite3_vfs_find(nullptr);
+
+    fl::error::raise_if(nullptr == base, "no default VFS");
+    fl::error::raise_if(base->iVersion < 2, "default VFS too old");
+    fl::error::raise_if(opts.queue_depth < 1, "queue_depth must be > 0");
+
+    vfs_options = opts;
+
+    uring_vfs = sqlite3_vfs{};
+    uring_vfs.iVersion = 2;
+    uring_vfs.szOsFile = int(real_offset()) + base->szOsFile;
+    uring_vfs.mxPathname = base->mxPathname;
+    uring_vfs.zName = fl::io_uring_vfs::name;
+    uring_vfs.pAppData = base;
+    uring_vfs.xOpen = x_open;
+    uring_vfs.xDelete = x_delete;
+    uring_vfs.xAccess = x_access;
+    uring_vfs.xFullPathname = x_full_pathname;
+    uring_vfs.xDlOpen = x_dl_open;
+    uring_vfs.xDlError = x_dl_error;
+    uring_vfs.xDlSym = x_dl_sym;
+    uring_vfs.xDlClose = x_dl_close;
+    uring_vfs.xRandomness = x_randomness;
+    uring_vfs.xSleep = x_sleep;
+    uring_vfs.xCurrentTime = x_current_time;
+    uring_vfs.xGetLastError = x_get_last_error;
+    uring_vfs.xCurrentTimeInt64 = x_current_time_int64;
+
+    int rc = sqlite3_vfs_register(&uring_vfs, make_default);
+    fl::error::raise_if(SQLITE_OK != rc, "sqlite3_vfs_register failed");
+  });
+}
+
+fl::io_uring_vfs::statistics
+fl::io_uring_vfs::stats()
+{
+  return { .submits = counters.submits,
+           .reads = counters.reads,
+           .writes = counters.writes,
+           .syncs = counters.syncs,
+           .batched_writes = counters.batched_writes,
+           .readahead_hits = counters.readahead_hits };
+}
@@ -0,0 +1,72 @@
+#ifndef FEDERLIEB_IO_URING_VFS_HXX
+#define FEDERLIEB_IO_URING_VFS_HXX
+
+#include <cstdint>
+
+#include "api.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+// A VFS that wraps the default one (normally "unix") and does reads,
+// writes and syncs of main database and WAL files through io_uring,
+// everything else, including locking, is left to the wrapped VFS. Only
+// available on Linux when built with `-DFEDERLIEB_IO_URING=ON`.
+//
+//   * Writes to a WAL file are queued and submitted together: once
+//     `wal_batch` writes are queued, with the last frame of a
+//     transaction, before the WAL is read or synced, and before a new
+//     WAL index header is published to other connections
+//     (`xShmBarrier` on the database file). A queued write that fails
+//     was reported as done already, so every later operation on the WAL
+//     file returns the error instead, until it is closed.
+//   * After two sequential page reads from a database file the next
+//     `readahead_pages` pages are read with one request. Read-ahead data
+//     is dropped on any write, lock change, or `xShmLock`.
+//
+// Select it per connection with `fl::db(path, flags, fl::io_uring_vfs::name)`,
+// which registers it with default options if needed. Files for which no
+// ring can be set up, for instance where io_uring is disabled, use the
+// wrapped VFS for everything, as do files whose ring fails later on.
+//
+// NOTE: Like the unix VFS, this keeps its own descriptor per open file
+// and closes it only when the last handle on that file through this VFS
+// is closed; closing a descriptor drops all POSIX locks of the process on
+// the file, so do not open the same file through other VFSes in the same
+// process at the same time.
+class io_uring_vfs
+{
+public:
+  static inline char const* const name = "fl_io_uring";
+
+  struct options
+  {
+    // Submission queue entries of the ring of each open file.
+    unsigned queue_depth = 64;
+    unsigned wal_batch = 32;
+    // Zero disables read-ahead.
+    unsigned readahead_pages = 32;
+  };
+
+  struct statistics
+  {
+    uint64_t submits = 0;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t syncs = 0;
+    uint64_t batched_writes = 0;
+    uint64_t readahead_hits = 0;
+  };
+
+  // Registers the VFS once, later calls change nothing. With
+  // `make_default` connections that do not name a VFS use this one.
+  static void register_vfs();
+  static void register_vfs(const options& opts, bool const make_default = false);
+
+  static statistics stats();
+};
+
+}
+
+#endif
@@ -61,6 +61,39 @@ fl::value::tag_invoke(const boost::json::value_from_tag&,
              ours);
 }
 
+void
+fl::value::tag_invoke(const boost::json::value_from_tag&,
+                      boost::json::value& theirs,
+                      const fl::value::text_view& ours)
+{
+  theirs = ours.value;
+}
+
+void
+fl::value::tag_invoke(const boost::json::value_from_tag&,
+                      boost::json::value& theirs,
+                      const fl::value::json_view& ours)
+{
+  theirs = boost::json::parse(ours.value);
+}
+
+void
+fl::value::tag_invoke(const boost::json::value_from_tag&,
+                      boost::json::value& theirs,
+                      const fl::value::blob_view& ours)
+{
+  fl::error::raise("BLOBs cannot be converted to JSON");
+}
+
+void
+fl::value::tag_invoke(const boost::json::value_from_tag&,
+                      boost::json::value& theirs,
+                      const fl::value::view& ours)
+{
+  std::visit([&theirs](auto&& e) { theirs = boost::json::value_from(e); },
+             ours);
+}
+
 void
 fl::vtab::tag_invoke(const boost::json::value_from_tag&,
                      boost::json::value& theirs,
@@ -112,6 +145,8 @@ fl::vtab::tag_invoke(const boost::json::value_from_tag&,
   tmp["columns"] = boost::json::value_from(ours.columns);
   detail::tag_invoke_optional(tmp["offset"], ours.offset);
   detail::tag_invoke_optional(tmp["limit"], ours.limit);
+  detail::tag_invoke_optional(tmp["offset_constraint"], ours.offset_constraint);
+  detail::tag_invoke_optional(tmp["limit_constraint"], ours.limit_constraint);
   tmp["distinct_mode"] = ours.distinct_mode;
   tmp["unique"] = ours.unique;
   tmp["estimated_rows"] = ours.estimated_rows;
@@ -153,6 +188,8 @@ fl::vtab::tag_invoke(const boost::json::value_to_tag<fl::vtab::index_info>&,
   fl::json::to(alias, "next_argv_index", ours.next_argv_index);
   fl::json::to(alias, "offset", ours.offset);
   fl::json::to(alias, "limit", ours.limit);
+  fl::json::to(alias, "offset_constraint", ours.offset_constraint);
+  fl::json::to(alias, "limit_constraint", ours.limit_constraint);
   fl::json::to(alias, "columns", ours.columns);
 
   return ours;
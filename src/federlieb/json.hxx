@@ -57,6 +57,22 @@ void
 tag_invoke(const boost::json::value_from_tag&,
            boost::json::value& theirs,
            const fl::value::variant& ours);
+void
+tag_invoke(const boost::json::value_from_tag&,
+           boost::json::value& theirs,
+           const fl::value::text_view& ours);
+void
+tag_invoke(const boost::json::value_from_tag&,
+           boost::json::value& theirs,
+           const fl::value::json_view& ours);
+void
+tag_invoke(const boost::json::value_from_tag&,
+           boost::json::value& theirs,
+           const fl::value::blob_view& ours);
+void
+tag_invoke(const boost::json::value_from_tag&,
+           boost::json::value& theirs,
+           const fl::value::view& ours);
 }
 
 namespace federlieb::vtab {
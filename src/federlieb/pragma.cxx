@@ -29,3 +29,287 @@ fl::pragma::table_xinfo(fl::db& db, const std::string& name)
 {
   return table_xinfo(db, "main", name);
 }
+
+namespace {
+
+int64_t
+get(fl::db& db, char const* const pragma)
+{
+  return db.select_scalar<int64_t>(fl::detail::format("PRAGMA {}", pragma));
+}
+
+void
+set(fl::db& db, char const* const pragma, int64_t const value)
+{
+  db.prepare(fl::detail::format("PRAGMA {} = {}", pragma, value)).execute();
+}
+
+}
+
+std::string_view
+fl::pragma::to_string(fl::pragma::journal const mode)
+{
+  switch (mode) {
+    case journal::delete_:
+      return "delete";
+    case journal::truncate:
+      return "truncate";
+    case journal::persist:
+      return "persist";
+    case journal::memory:
+      return "memory";
+    case journal::wal:
+      return "wal";
+    case journal::off:
+      return "off";
+  }
+
+  fl::error::raise("unknown journal mode");
+}
+
+fl::pragma::journal
+fl::pragma::to_journal(std::string_view const name)
+{
+  for (auto mode : { journal::delete_,
+                     journal::truncate,
+                     journal::persist,
+                     journal::memory,
+                     journal::wal,
+                     journal::off }) {
+    // NOTE: SQLite reports the mode in lower case.
+    if (to_string(mode) == name) {
+      return mode;
+    }
+  }
+
+  fl::error::raise("unknown journal mode");
+}
+
+int64_t
+fl::pragma::mmap_size(fl::db& db)
+{
+  return get(db, "mmap_size");
+}
+
+void
+fl::pragma::mmap_size(fl::db& db, int64_t const bytes)
+{
+  set(db, "mmap_size", bytes);
+}
+
+int64_t
+fl::pragma::cache_size(fl::db& db)
+{
+  return get(db, "cache_size");
+}
+
+void
+fl::pragma::cache_size(fl::db& db, int64_t const value)
+{
+  set(db, "cache_size", value);
+}
+
+fl::pragma::journal
+fl::pragma::journal_mode(fl::db& db)
+{
+  return to_journal(db.select_scalar<std::string>("PRAGMA journal_mode"));
+}
+
+fl::pragma::journal
+fl::pragma::journal_mode(fl::db& db, fl::pragma::journal const mode)
+{
+  return to_journal(db.select_scalar<std::string>(
+    fl::detail::format("PRAGMA journal_mode = {}", std::string(to_string(mode)))));
+}
+
+fl::pragma::sync
+fl::pragma::synchronous(fl::db& db)
+{
+  return static_cast<fl::pragma::sync>(get(db, "synchronous"));
+}
+
+void
+fl::pragma::synchronous(fl::db& db, fl::pragma::sync const value)
+{
+  set(db, "synchronous", static_cast<int64_t>(value));
+}
+
+fl::pragma::temp_storage
+fl::pragma::temp_store(fl::db& db)
+{
+  return static_cast<fl::pragma::temp_storage>(get(db, "temp_store"));
+}
+
+void
+fl::pragma::temp_store(fl::db& db, fl::pragma::temp_storage const value)
+{
+  set(db, "temp_store", static_cast<int64_t>(value));
+}
+
+int64_t
+fl::pragma::page_size(fl::db& db)
+{
+  return get(db, "page_size");
+}
+
+void
+fl::pragma::page_size(fl::db& db, int64_t const bytes)
+{
+  set(db, "page_size", bytes);
+}
+
+int64_t
+fl::pragma::wal_autocheckpoint(fl::db& db)
+{
+  return get(db, "wal_autocheckpoint");
+}
+
+void
+fl::pragma::wal_autocheckpoint(fl::db& db, int64_t const pages)
+{
+  set(db, "wal_autocheckpoint", pages);
+}
+
+int64_t
+fl::pragma::threads(fl::db& db)
+{
+  return get(db, "threads");
+}
+
+void
+fl::pragma::threads(fl::db& db, int64_t const count)
+{
+  set(db, "threads", count);
+}
+
+fl::pragma::settings
+fl::pragma::current(fl::db& db, const fl::pragma::settings& of)
+{
+  fl::pragma::settings result;
+
+  if (of.mmap_size) {
+    result.mmap_size = mmap_size(db);
+  }
+
+  if (of.cache_size) {
+    result.cache_size = cache_size(db);
+  }
+
+  if (of.journal_mode) {
+    result.journal_mode = journal_mode(db);
+  }
+
+  if (of.synchronous) {
+    result.synchronous = synchronous(db);
+  }
+
+  if (of.temp_store) {
+    result.temp_store = temp_store(db);
+  }
+
+  if (of.page_size) {
+    result.page_size = page_size(db);
+  }
+
+  if (of.wal_autocheckpoint) {
+    result.wal_autocheckpoint = wal_autocheckpoint(db);
+  }
+
+  if (of.threads) {
+    result.threads = threads(db);
+  }
+
+  return result;
+}
+
+void
+fl::pragma::apply(fl::db& db, const fl::pragma::settings& settings)
+{
+  // NOTE: page_size first, it has to be set before anything creates the
+  // database file.
+  if (settings.page_size) {
+    page_size(db, *settings.page_size);
+  }
+
+  if (settings.journal_mode) {
+    journal_mode(db, *settings.journal_mode);
+  }
+
+  if (settings.mmap_size) {
+    mmap_size(db, *settings.mmap_size);
+  }
+
+  if (settings.cache_size) {
+    cache_size(db, *settings.cache_size);
+  }
+
+  if (settings.synchronous) {
+    synchronous(db, *settings.synchronous);
+  }
+
+  if (settings.temp_store) {
+    temp_store(db, *settings.temp_store);
+  }
+
+  if (settings.wal_autocheckpoint) {
+    wal_autocheckpoint(db, *settings.wal_autocheckpoint);
+  }
+
+  if (settings.threads) {
+    threads(db, *settings.threads);
+  }
+}
+
+const fl::pragma::settings&
+fl::pragma::profile(std::string_view const name)
+{
+  static const fl::pragma::settings bulk_load{
+    .cache_size = -262144,
+    .synchronous = sync::off,
+    .temp_store = temp_storage::memory,
+    .wal_autocheckpoint = 0,
+  };
+
+  static const fl::pragma::settings read_mostly_mmap{
+    .mmap_size = int64_t(1) << 30,
+    .cache_size = -65536,
+    .temp_store = temp_storage::memory,
+  };
+
+  static const fl::pragma::settings in_memory_scratch{
+    .synchronous = sync::off,
+    .temp_store = temp_storage::memory,
+    .threads = 2,
+  };
+
+  if (name == "bulk-load") {
+    return bulk_load;
+  }
+
+  if (name == "read-mostly-mmap") {
+    return read_mostly_mmap;
+  }
+
+  if (name == "in-memory-scratch") {
+    return in_memory_scratch;
+  }
+
+  fl::error::raise("unknown pragma profile");
+}
+
+fl::pragma::scoped_settings::scoped_settings(
+  fl::db db,
+  const fl::pragma::settings& settings)
+  : db_(db)
+  , previous_(current(db_, settings))
+{
+  apply(db_, settings);
+}
+
+fl::pragma::scoped_settings::~scoped_settings()
+{
+  try {
+    apply(db_, previous_);
+  } catch (...) {
+  }
+}
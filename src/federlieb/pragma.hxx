@@ -1,6 +1,9 @@
 #ifndef FEDERLIEB_PRAGMA_HXX
 #define FEDERLIEB_PRAGMA_HXX
 
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace federlieb::pragma {
@@ -37,6 +40,157 @@ table_xinfo(fl::db& db, const std::string& schema, const std::string& name);
 std::vector<table_xinfo_data>
 table_xinfo(fl::db& db, const std::string& name);
 
+// Performance settings of a connection, the getters read the current
+// value, the setters change it. All apply to the main schema.
+
+enum class journal
+{
+  delete_,
+  truncate,
+  persist,
+  memory,
+  wal,
+  off
+};
+
+enum class sync
+{
+  off = 0,
+  normal = 1,
+  full = 2,
+  extra = 3
+};
+
+enum class temp_storage
+{
+  default_ = 0,
+  file = 1,
+  memory = 2
+};
+
+std::string_view
+to_string(fl::pragma::journal const mode);
+
+fl::pragma::journal
+to_journal(std::string_view const name);
+
+// Bytes, zero disables memory-mapped I/O. SQLite silently caps the value
+// at its compile-time maximum.
+int64_t
+mmap_size(fl::db& db);
+
+void
+mmap_size(fl::db& db, int64_t const bytes);
+
+// Pages when positive, KiB when negative.
+int64_t
+cache_size(fl::db& db);
+
+void
+cache_size(fl::db& db, int64_t const value);
+
+fl::pragma::journal
+journal_mode(fl::db& db);
+
+// Returns the mode in effect afterwards, SQLite refuses some changes,
+// for instance to WAL for in-memory databases, or inside a transaction.
+fl::pragma::journal
+journal_mode(fl::db& db, fl::pragma::journal const mode);
+
+fl::pragma::sync
+synchronous(fl::db& db);
+
+void
+synchronous(fl::db& db, fl::pragma::sync const value);
+
+fl::pragma::temp_storage
+temp_store(fl::db& db);
+
+void
+temp_store(fl::db& db, fl::pragma::temp_storage const value);
+
+// Only takes effect before the database is created, or on VACUUM.
+int64_t
+page_size(fl::db& db);
+
+void
+page_size(fl::db& db, int64_t const bytes);
+
+// Pages, zero or less disables automatic checkpoints.
+int64_t
+wal_autocheckpoint(fl::db& db);
+
+void
+wal_autocheckpoint(fl::db& db, int64_t const pages);
+
+// Auxiliary threads a prepared statement may use for sorting.
+int64_t
+threads(fl::db& db);
+
+void
+threads(fl::db& db, int64_t const count);
+
+// A combination of the settings above, unset ones are left alone.
+struct settings
+{
+  std::optional<int64_t> mmap_size{};
+  std::optional<int64_t> cache_size{};
+  std::optional<fl::pragma::journal> journal_mode{};
+  std::optional<fl::pragma::sync> synchronous{};
+  std::optional<fl::pragma::temp_storage> temp_store{};
+  std::optional<int64_t> page_size{};
+  std::optional<int64_t> wal_autocheckpoint{};
+  std::optional<int64_t> threads{};
+};
+
+// The current values of the settings `of` sets.
+fl::pragma::settings
+current(fl::db& db, const fl::pragma::settings& of);
+
+void
+apply(fl::db& db, const fl::pragma::settings& settings);
+
+// Named combinations:
+//
+//   * "bulk-load": no syncs, no automatic checkpoints, a 256 MiB page
+//     cache and temporary tables in memory. A crash can lose the
+//     transactions committed meanwhile, but not corrupt the database.
+//   * "read-mostly-mmap": reads through a 1 GiB memory map with a 64 MiB
+//     page cache and temporary tables in memory.
+//   * "in-memory-scratch": for the `:memory:` databases used as scratch
+//     space, no syncs, temporary tables in memory, and sorter threads.
+//
+// Unknown names raise an error.
+const fl::pragma::settings&
+profile(std::string_view const name);
+
+// Applies settings and restores the previous values of the changed ones
+// when going out of scope.
+//
+// NOTE: The journal mode cannot be changed inside a transaction, the
+// scope has to end outside of one then.
+class scoped_settings
+{
+public:
+  scoped_settings(fl::db db, const fl::pragma::settings& settings);
+  ~scoped_settings();
+
+  scoped_settings(const scoped_settings&) = delete;
+  scoped_settings& operator=(const scoped_settings&) = delete;
+
+  const fl::pragma::settings& previous() const { return previous_; }
+
+protected:
+  fl::db db_;
+  fl::pragma::settings previous_;
+};
+
+[[nodiscard]] inline fl::pragma::scoped_settings
+use_profile(fl::db& db, std::string_view const name)
+{
+  return { db, profile(name) };
+}
+
 }
 
 #endif
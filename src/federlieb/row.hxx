@@ -14,6 +14,9 @@ class field;
 class row;
 class stmt;
 
+template<typename T>
+class row_decoder;
+
 class row_iterator
   : public boost::stl_interfaces::iterator_interface<
       fl::row_iterator,
@@ -75,6 +78,8 @@ protected:
   int size_ = 0;
   friend class fl::field;
   friend class fl::row_iterator;
+  template<typename T>
+  friend class fl::row_decoder;
   sqlite3* db() const;
 };
 
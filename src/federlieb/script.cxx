@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cctype>
+
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+fl::script::script(fl::db db, std::string_view const sql)
+  : db_(db)
+{
+  std::string current;
+
+  // Statements cannot be split by preparing them, later ones may depend
+  // on tables the earlier ones create.
+  for (auto&& c : sql) {
+    current.push_back(c);
+
+    if (';' == c && fl::api(sqlite3_complete, nullptr, current.c_str())) {
+      parts_.push_back({ std::move(current) });
+      current.clear();
+    }
+  }
+
+  auto blank = std::ranges::all_of(
+    current, [](unsigned char c) { return std::isspace(c); });
+
+  if (!blank) {
+    parts_.push_back({ std::move(current) });
+  }
+}
+
+fl::script&
+fl::script::bind(const std::string& name, const fl::value::variant& value)
+{
+  named_[name] = value;
+  return *this;
+}
+
+fl::script&
+fl::script::clear_bindings()
+{
+  named_.clear();
+  positional_.clear();
+  return *this;
+}
+
+size_t
+fl::script::reprepares() const
+{
+  size_t result = 0;
+
+  for (auto&& part : parts_) {
+    result += part.retries;
+
+    if (part.prepared && !part.empty) {
+      result += part.stmt.status().reprepares;
+    }
+  }
+
+  return result;
+}
+
+void
+fl::script::prepare(part& part)
+{
+  sqlite3_stmt* stmt = nullptr;
+  auto db = db_.ptr();
+
+  fl::api(sqlite3_prepare_v3,
+          { SQLITE_OK },
+          db.get(),
+          db.get(),
+          part.sql.data(),
+          fl::detail::safe_to<int>(part.sql.size()),
+          SQLITE_PREPARE_PERSISTENT,
+          &stmt,
+          nullptr);
+
+  part.prepared = true;
+
+  // Only whitespace and comments.
+  if (nullptr == stmt) {
+    part.empty = true;
+    return;
+  }
+
+  part.empty = false;
+  part.stmt =
+    fl::stmt(db, std::shared_ptr<sqlite3_stmt>(stmt, sqlite3_finalize));
+}
+
+void
+fl::script::bind(part& part)
+{
+  auto& stmt = part.stmt;
+  auto count = stmt.bind_parameter_count();
+
+  stmt.clear_bindings();
+
+  for (int ix = 1; ix <= count && ix <= int(positional_.size()); ++ix) {
+    stmt.bind(ix, positional_[ix - 1]);
+  }
+
+  if (named_.empty()) {
+    return;
+  }
+
+  for (int ix = 1; ix <= count; ++ix) {
+    auto name = stmt.bind_parameter_name(ix);
+
+    if (!name) {
+      continue;
+    }
+
+    auto it = named_.find(*name);
+
+    if (it != named_.end()) {
+      stmt.bind(ix, it->second);
+    }
+  }
+}
+
+void
+fl::script::run(part& part)
+{
+  if (!part.prepared) {
+    prepare(part);
+  }
+
+  if (part.empty) {
+    return;
+  }
+
+  for (bool retry = true;; retry = false) {
+    try {
+      part.stmt.reset();
+      bind(part);
+      for ([[maybe_unused]] auto&& row : part.stmt.execute()) {
+      }
+      return;
+    } catch (...) {
+      auto db = db_.ptr().get();
+      auto rc = fl::api(sqlite3_errcode, db, db);
+
+      if (!retry || SQLITE_SCHEMA != rc) {
+        throw;
+      }
+    }
+
+    // SQLite gave up re-preparing the statement on its own.
+    prepare(part);
+    part.retries++;
+  }
+}
+
+void
+fl::script::execute()
+{
+  for (auto&& part : parts_) {
+    run(part);
+  }
+
+  runs_++;
+}
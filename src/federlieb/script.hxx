@@ -0,0 +1,87 @@
+#ifndef FEDERLIEB_SCRIPT_HXX
+#define FEDERLIEB_SCRIPT_HXX
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "federlieb/db.hxx"
+#include "federlieb/stmt.hxx"
+#include "federlieb/value.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+// A script of several statements that is prepared once and can then be
+// executed any number of times, unlike `fl::db::execute_script`, which
+// prepares every statement again on each call. Statements are split up
+// front but prepared only when they are first reached, so a statement can
+// refer to tables created earlier in the same script. Statements are kept
+// with `SQLITE_PREPARE_PERSISTENT`; SQLite re-prepares them when the
+// schema has changed, and a statement that still fails with `SQLITE_SCHEMA`
+// is prepared from its text again and retried once.
+//
+// Each run executes every statement to completion. Parameters are bound by
+// name to each statement that has a parameter of that name, and by number
+// to each statement that has that many parameters. They are kept for the
+// following runs until changed or cleared.
+class script
+{
+public:
+  script(fl::db db, std::string_view const sql);
+
+  // Number of statements in the script.
+  size_t size() const { return parts_.size(); }
+
+  template<typename Value>
+  fl::script& bind(const std::string& name, const Value& value)
+  {
+    named_[name] = fl::value::from(value);
+    return *this;
+  }
+
+  fl::script& bind(const std::string& name, const fl::value::variant& value);
+
+  fl::script& clear_bindings();
+
+  void execute();
+
+  template<typename... T>
+  inline void execute(T&&... param)
+  {
+    positional_.clear();
+    (positional_.push_back(fl::value::from(param)), ...);
+    execute();
+  }
+
+  // Runs of the script so far and statements prepared again after a
+  // schema change, by SQLite or by `fl::script`.
+  size_t runs() const { return runs_; }
+  size_t reprepares() const;
+
+protected:
+  struct part
+  {
+    std::string sql;
+    fl::stmt stmt{};
+    bool prepared = false;
+    bool empty = false;
+    size_t retries = 0;
+  };
+
+  void prepare(part& part);
+  void run(part& part);
+  void bind(part& part);
+
+  fl::db db_;
+  std::vector<part> parts_;
+  std::map<std::string, fl::value::variant> named_;
+  std::vector<fl::value::variant> positional_;
+  size_t runs_ = 0;
+};
+
+}
+
+#endif
@@ -30,9 +30,38 @@ fl::stmt&
 fl::stmt::clear_bindings()
 {
   fl::api(sqlite3_clear_bindings, { SQLITE_OK }, db(), stmt_.get());
+  borrowed_ = false;
   return *this;
 };
 
+fl::stmt::borrow_scope::borrow_scope(fl::stmt& stmt)
+  : stmt_(stmt)
+{
+  stmt_.borrow_depth_++;
+}
+
+fl::stmt::borrow_scope::~borrow_scope()
+{
+  stmt_.borrow_depth_--;
+
+  if (0 == stmt_.borrow_depth_ && stmt_.borrowed_) {
+    // NOTE: must not throw; sqlite3_clear_bindings always returns SQLITE_OK.
+    sqlite3_clear_bindings(stmt_.stmt_.get());
+    stmt_.borrowed_ = false;
+  }
+}
+
+sqlite3_destructor_type
+fl::stmt::text_and_blob_destructor()
+{
+  if (borrow_depth_ > 0) {
+    borrowed_ = true;
+    return SQLITE_STATIC;
+  }
+
+  return SQLITE_TRANSIENT;
+}
+
 fl::stmt&
 fl::stmt::bind(int const col, const nullptr_t& v)
 {
@@ -41,37 +70,52 @@ fl::stmt::bind(int const col, const nullptr_t& v)
 }
 
 fl::stmt&
-fl::stmt::bind(int const col, const fl::value::blob& v)
+fl::stmt::bind(int const col, const std::string_view& v)
 {
-  fl::api(sqlite3_bind_blob64,
+  // NOTE: a nullptr would bind NULL rather than an empty string.
+  fl::api(sqlite3_bind_text64,
           { SQLITE_OK },
           db(),
           stmt_.get(),
           col,
-          (&v.value[0]),
-          fl::detail::safe_to<int>(v.value.size()),
-          SQLITE_TRANSIENT);
+          v.empty() ? "" : v.data(),
+          fl::detail::safe_to<sqlite3_uint64>(v.size()),
+          text_and_blob_destructor(),
+          SQLITE_UTF8);
   return *this;
 }
 
 fl::stmt&
-fl::stmt::bind(int const col, const fl::value::text& v)
+fl::stmt::bind(int const col, const std::span<const std::byte>& v)
 {
-  fl::api(sqlite3_bind_text,
+  // NOTE: a nullptr would bind NULL rather than an empty blob.
+  fl::api(sqlite3_bind_blob64,
           { SQLITE_OK },
           db(),
           stmt_.get(),
           col,
-          v.value.c_str(),
-          fl::detail::safe_to<int>(v.value.size()),
-          SQLITE_TRANSIENT);
+          v.empty() ? static_cast<void const*>("") : v.data(),
+          fl::detail::safe_to<sqlite3_uint64>(v.size()),
+          text_and_blob_destructor());
   return *this;
 }
 
+fl::stmt&
+fl::stmt::bind(int const col, const fl::value::blob& v)
+{
+  return bind(col, std::span<const std::byte>(v.value));
+}
+
+fl::stmt&
+fl::stmt::bind(int const col, const fl::value::text& v)
+{
+  return bind(col, std::string_view(v.value));
+}
+
 fl::stmt&
 fl::stmt::bind(int const col, const fl::value::json& v)
 {
-  return bind(col, fl::value::text{ v.value });
+  return bind(col, std::string_view(v.value));
 }
 
 fl::stmt&
@@ -102,6 +146,31 @@ fl::stmt::bind(int const col, const fl::value::variant& variant)
   return *this;
 }
 
+fl::stmt&
+fl::stmt::bind(int const col, const fl::value::text_view& v)
+{
+  return bind(col, v.value);
+}
+
+fl::stmt&
+fl::stmt::bind(int const col, const fl::value::blob_view& v)
+{
+  return bind(col, v.value);
+}
+
+fl::stmt&
+fl::stmt::bind(int const col, const fl::value::json_view& v)
+{
+  return bind(col, v.value);
+}
+
+fl::stmt&
+fl::stmt::bind(int const col, const fl::value::view& view)
+{
+  std::visit([this, &col](auto&& value) { bind(col, value); }, view);
+  return *this;
+}
+
 fl::stmt&
 fl::stmt::bind(int const col, const fl::field& field)
 {
@@ -143,6 +212,11 @@ fl::stmt&
 fl::stmt::reset()
 {
   fl::api(sqlite3_reset, { SQLITE_OK }, db(), stmt_.get());
+
+  if (borrowed_) {
+    clear_bindings();
+  }
+
   return *this;
 };
 
@@ -152,6 +226,30 @@ fl::stmt::column_count() const
   return fl::api(sqlite3_column_count, db(), stmt_.get());
 };
 
+fl::stmt_status
+fl::stmt_status::of(sqlite3_stmt* stmt, bool const reset)
+{
+  auto counter = [stmt, reset](int const op) -> int64_t {
+    return fl::api(sqlite3_stmt_status, nullptr, stmt, op, reset ? 1 : 0);
+  };
+
+  return {
+    .fullscan_steps = counter(SQLITE_STMTSTATUS_FULLSCAN_STEP),
+    .sorts = counter(SQLITE_STMTSTATUS_SORT),
+    .autoindex = counter(SQLITE_STMTSTATUS_AUTOINDEX),
+    .vm_steps = counter(SQLITE_STMTSTATUS_VM_STEP),
+    .reprepares = counter(SQLITE_STMTSTATUS_REPREPARE),
+    .runs = counter(SQLITE_STMTSTATUS_RUN),
+    .memory_used = counter(SQLITE_STMTSTATUS_MEMUSED),
+  };
+}
+
+fl::stmt_status
+fl::stmt::status(bool const reset) const
+{
+  return fl::stmt_status::of(stmt_.get(), reset);
+}
+
 bool
 fl::stmt::is_busy() const
 {
@@ -207,7 +305,8 @@ fl::stmt::db() const
 fl::stmt&
 fl::stmt::execute()
 {
-  reset();
+  // NOTE: Unlike `reset()` this keeps borrowed bindings.
+  fl::api(sqlite3_reset, { SQLITE_OK }, db(), stmt_.get());
 
   int rc =
     fl::api(sqlite3_step, { SQLITE_DONE, SQLITE_ROW }, db(), stmt_.get());
@@ -221,6 +320,91 @@ fl::stmt::execute()
   return *this;
 }
 
+fl::batch&
+fl::stmt::fetch_batch(size_t const n, fl::batch& batch)
+{
+  fl::error::raise_if(state_ == state::prepared, "Statement not executed");
+
+  auto count = column_count();
+  auto stmt = stmt_.get();
+
+  batch.start(count, n);
+
+  for (int ix = 0; ix < count; ++ix) {
+    batch.columns_[ix].name = fl::api(sqlite3_column_name, db(), stmt, ix);
+  }
+
+  while (batch.rows_ < n && state_ == state::running) {
+
+    for (int ix = 0; ix < count; ++ix) {
+      auto& column = batch.columns_[ix];
+      auto type = fl::api(sqlite3_column_type, db(), stmt, ix);
+
+      switch (type) {
+        case SQLITE_INTEGER:
+          batch.append(column,
+                       type,
+                       fl::api(sqlite3_column_int64, db(), stmt, ix),
+                       0,
+                       nullptr,
+                       0);
+          break;
+        case SQLITE_FLOAT:
+          batch.append(column,
+                       type,
+                       0,
+                       fl::api(sqlite3_column_double, db(), stmt, ix),
+                       nullptr,
+                       0);
+          break;
+        case SQLITE_TEXT:
+          batch.append(column,
+                       type,
+                       0,
+                       0,
+                       fl::api(sqlite3_column_text, db(), stmt, ix),
+                       fl::api(sqlite3_column_bytes, db(), stmt, ix));
+          break;
+        case SQLITE_BLOB:
+          batch.append(column,
+                       type,
+                       0,
+                       0,
+                       fl::api(sqlite3_column_blob, db(), stmt, ix),
+                       fl::api(sqlite3_column_bytes, db(), stmt, ix));
+          break;
+        default:
+          batch.append(column, type, 0, 0, nullptr, 0);
+      }
+    }
+
+    batch.rows_++;
+
+    int rc =
+      fl::api(sqlite3_step, { SQLITE_DONE, SQLITE_ROW }, db(), stmt_.get());
+
+    if (SQLITE_DONE == rc) {
+      state_ = state::done;
+    }
+  }
+
+  return batch;
+}
+
+fl::batch
+fl::stmt::fetch_batch(size_t const n)
+{
+  fl::batch batch;
+  fetch_batch(n, batch);
+  return batch;
+}
+
+fl::batch_awaitable
+fl::stmt::next_batch(fl::worker& worker, size_t const n)
+{
+  return fl::batch_awaitable(*this, worker, n);
+}
+
 fl::column_view
 fl::stmt::columns()
 {
@@ -1,6 +1,11 @@
 #ifndef FEDERLIEB_STMT_HXX
 #define FEDERLIEB_STMT_HXX
 
+#include <span>
+#include <string_view>
+
+#include "federlieb/batch.hxx"
+#include "federlieb/bulk.hxx"
 #include "federlieb/column.hxx"
 #include "federlieb/detail.hxx"
 #include "federlieb/error.hxx"
@@ -11,6 +16,9 @@ namespace federlieb {
 
 namespace fl = ::federlieb;
 
+class worker;
+class batch_awaitable;
+
 class stmt_iterator
   : public boost::stl_interfaces::
       iterator_interface<fl::stmt_iterator, std::input_iterator_tag, fl::row>
@@ -45,6 +53,21 @@ protected:
   sqlite3* db() const;
 };
 
+// Counters from `sqlite3_stmt_status`, see
+// https://www.sqlite.org/c3ref/c_stmtstatus_counter.html
+struct stmt_status
+{
+  int64_t fullscan_steps = 0;
+  int64_t sorts = 0;
+  int64_t autoindex = 0;
+  int64_t vm_steps = 0;
+  int64_t reprepares = 0;
+  int64_t runs = 0;
+  int64_t memory_used = 0;
+
+  static fl::stmt_status of(sqlite3_stmt* stmt, bool const reset = false);
+};
+
 class stmt
 {
 public:
@@ -61,7 +84,29 @@ public:
     }
   }
 
+  class borrow_scope
+  {
+  public:
+    explicit borrow_scope(fl::stmt& stmt);
+    ~borrow_scope();
+
+    borrow_scope(const borrow_scope&) = delete;
+    borrow_scope& operator=(const borrow_scope&) = delete;
+
+  protected:
+    fl::stmt& stmt_;
+  };
+
+  // While the returned scope is alive, TEXT and BLOB values are bound with
+  // `SQLITE_STATIC` instead of being copied. The caller has to keep the
+  // bound memory alive and unchanged until the next `reset()` or
+  // `clear_bindings()`, both of which drop borrowed bindings, as does the
+  // end of the scope. This applies to this object, not to copies of it.
+  [[nodiscard]] borrow_scope borrow() { return borrow_scope(*this); }
+
   fl::stmt& bind(int const col, const nullptr_t& v);
+  fl::stmt& bind(int const col, const std::string_view& v);
+  fl::stmt& bind(int const col, const std::span<const std::byte>& v);
   fl::stmt& bind(int const col, const fl::value::blob& v);
   fl::stmt& bind(int const col, const fl::value::text& v);
   fl::stmt& bind(int const col, const fl::value::json& v);
@@ -69,6 +114,10 @@ public:
   fl::stmt& bind(int const col, const fl::value::real& v);
   fl::stmt& bind(int const col, const fl::value::null& v);
   fl::stmt& bind(int const col, const fl::value::variant& variant);
+  fl::stmt& bind(int const col, const fl::value::text_view& v);
+  fl::stmt& bind(int const col, const fl::value::blob_view& v);
+  fl::stmt& bind(int const col, const fl::value::json_view& v);
+  fl::stmt& bind(int const col, const fl::value::view& view);
   fl::stmt& bind(int const col, const fl::field& field);
 
   fl::stmt& bind_pointer(int const col, char const* const id, void* ptr);
@@ -90,7 +139,16 @@ public:
   template<fl::compatible_type T>
   inline fl::stmt& bind(int const col, const T& value)
   {
-    return bind(col, fl::value::from(value));
+    if constexpr (std::integral<T>) {
+      return bind(
+        col, fl::value::integer{ fl::detail::safe_to<sqlite3_int64>(value) });
+    } else if constexpr (std::same_as<T, double>) {
+      return bind(col, fl::value::real{ value });
+    } else if constexpr (std::same_as<T, std::string>) {
+      return bind(col, std::string_view(value));
+    } else {
+      return bind(col, std::span<const std::byte>(value));
+    }
   }
 
   fl::stmt& execute();
@@ -128,6 +186,38 @@ public:
     }
   }
 
+  // Like `executemany` above, but runs in chunked savepoints, see
+  // `fl::bulk_options`, and reports what was loaded how quickly.
+  template<std::ranges::range T>
+  inline fl::bulk_stats executemany(T&& many_params,
+                                    const fl::bulk_options& options)
+  {
+    fl::bulk_transaction transaction(db(), options);
+
+    for (auto&& row : many_params) {
+      size_t bytes = 0;
+      reset();
+      for (auto index = 1; auto&& param : row) {
+        bind(index++, param);
+        bytes += fl::detail::bound_bytes(param);
+      }
+      execute();
+      transaction.row_done(bytes);
+    }
+
+    return transaction.commit();
+  }
+
+  // Copies up to `n` rows, starting with the current one, into `batch`
+  // and advances past them. An empty batch means the statement is done.
+  fl::batch& fetch_batch(size_t const n, fl::batch& batch);
+  fl::batch fetch_batch(size_t const n);
+
+  // `co_await stmt.next_batch(worker)` executes the statement if needed
+  // and fetches the next batch on the worker's thread, see `fl::worker`.
+  // An empty batch means the statement is done.
+  fl::batch_awaitable next_batch(fl::worker& worker, size_t const n = 256);
+
   stmt_iterator begin() { return stmt_iterator(this); }
   stmt_iterator::sentinel end() { return stmt_iterator::sentinel(); }
   bool empty() { return begin() == end(); }
@@ -147,6 +237,9 @@ public:
   std::string expanded_sql() const;
   std::string sql() const;
 
+  // With `reset` the counters start over, except `memory_used`.
+  fl::stmt_status status(bool const reset = false) const;
+
   bool is_busy() const;
   bool is_explain() const;
   bool is_readonly() const;
@@ -160,6 +253,9 @@ protected:
   friend class fl::row;
   friend class fl::field;
   friend class fl::column;
+  friend class fl::batch_awaitable;
+  template<typename T>
+  friend class fl::row_decoder;
 
   enum class state
   {
@@ -168,6 +264,11 @@ protected:
     done
   } state_ = state::prepared;
 
+  int borrow_depth_ = 0;
+  bool borrowed_ = false;
+
+  sqlite3_destructor_type text_and_blob_destructor();
+
   sqlite3* db() const;
   std::shared_ptr<sqlite3> db_ = nullptr;
   std::shared_ptr<sqlite3_stmt> stmt_ = nullptr;
@@ -0,0 +1,118 @@
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+std::shared_ptr<sqlite3_stmt>
+fl::stmt_cache::prepare(sqlite3* db,
+                        const std::string_view sql,
+                        unsigned int const flags)
+{
+  sqlite3_stmt* stmt = nullptr;
+
+  fl::api(sqlite3_prepare_v3,
+          { SQLITE_OK },
+          db,
+          db,
+          sql.data(),
+          fl::detail::safe_to<int>(sql.size()),
+          flags,
+          &stmt,
+          nullptr);
+
+  fl::error::raise_if(nullptr == stmt,
+                      "sqlite3_prepare returned a nullptr stmt");
+
+  return std::shared_ptr<sqlite3_stmt>(stmt, sqlite3_finalize);
+}
+
+std::shared_ptr<sqlite3_stmt>
+fl::stmt_cache::lease(sqlite3* db, const std::string_view sql)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  auto found = index_.find(sql);
+
+  if (index_.end() != found && !found->second->lease.expired()) {
+    // Statement is in use elsewhere, e.g. an outer loop iterating over
+    // the result while an inner loop runs the same query again.
+    misses_++;
+    return prepare(db, sql, 0);
+  }
+
+  if (index_.end() == found) {
+    misses_++;
+
+    if (0 == capacity_) {
+      return prepare(db, sql, 0);
+    }
+
+    auto owner = prepare(db, sql, SQLITE_PREPARE_PERSISTENT);
+
+    lru_.push_front(entry{ std::string(sql), owner, {} });
+    index_.insert({ lru_.front().sql, lru_.begin() });
+
+    evict_to(capacity_);
+
+  } else {
+    hits_++;
+    lru_.splice(lru_.begin(), lru_, found->second);
+  }
+
+  auto& current = lru_.front();
+
+  // The lease keeps the owning pointer alive, so evicting a leased
+  // statement defers finalization until the lease is released.
+  auto owner = current.owner;
+  auto lease = std::shared_ptr<sqlite3_stmt>(
+    owner.get(), [owner](sqlite3_stmt* stmt) noexcept {
+      sqlite3_reset(stmt);
+      sqlite3_clear_bindings(stmt);
+    });
+
+  current.lease = lease;
+
+  return lease;
+}
+
+void
+fl::stmt_cache::evict_to(size_t const size)
+{
+  while (lru_.size() > size) {
+    index_.erase(lru_.back().sql);
+    lru_.pop_back();
+    evictions_++;
+  }
+}
+
+void
+fl::stmt_cache::capacity(size_t const capacity)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  capacity_ = capacity;
+  evict_to(capacity_);
+}
+
+size_t
+fl::stmt_cache::capacity() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return capacity_;
+}
+
+fl::stmt_cache::statistics
+fl::stmt_cache::stats() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return { .hits = hits_,
+           .misses = misses_,
+           .evictions = evictions_,
+           .size = lru_.size(),
+           .capacity = capacity_ };
+}
+
+void
+fl::stmt_cache::clear()
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  evict_to(0);
+}
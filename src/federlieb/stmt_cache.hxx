@@ -0,0 +1,76 @@
+#ifndef FEDERLIEB_STMT_CACHE_HXX
+#define FEDERLIEB_STMT_CACHE_HXX
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "api.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+// Least-recently-used cache of prepared statements keyed by SQL text. The
+// cache owns the `sqlite3_stmt` handles and finalizes them on eviction (or
+// once the last lease on an evicted statement is released). Statements are
+// handed out as leases; releasing a lease resets the statement and clears
+// its bindings, so locks are not held by idle cached statements. When the
+// cached statement for some SQL is still leased, a fresh uncached statement
+// is prepared instead.
+class stmt_cache
+{
+public:
+  struct statistics
+  {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+  };
+
+  explicit stmt_cache(size_t const capacity = 32)
+    : capacity_(capacity)
+  {}
+
+  std::shared_ptr<sqlite3_stmt> lease(sqlite3* db, const std::string_view sql);
+
+  void capacity(size_t const capacity);
+  size_t capacity() const;
+
+  fl::stmt_cache::statistics stats() const;
+  void clear();
+
+protected:
+  struct entry
+  {
+    std::string sql;
+    std::shared_ptr<sqlite3_stmt> owner;
+    std::weak_ptr<sqlite3_stmt> lease;
+  };
+
+  void evict_to(size_t const size);
+
+  static std::shared_ptr<sqlite3_stmt> prepare(sqlite3* db,
+                                               const std::string_view sql,
+                                               unsigned int const flags);
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+
+  // NOTE: keys are views into `entry::sql`, list nodes are stable.
+  std::list<entry> lru_;
+  std::unordered_map<std::string_view, std::list<entry>::iterator> index_;
+};
+
+}
+
+#endif
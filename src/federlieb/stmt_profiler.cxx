@@ -0,0 +1,141 @@
+#include "federlieb/federlieb.hxx"
+
+#include <bit>
+
+namespace fl = ::federlieb;
+
+namespace {
+
+std::mutex registry_mutex;
+std::unordered_map<sqlite3*, std::shared_ptr<fl::stmt_profiler>> registry;
+
+}
+
+std::shared_ptr<fl::stmt_profiler>
+fl::stmt_profiler::install(sqlite3* db)
+{
+  std::shared_ptr<fl::stmt_profiler> profiler;
+
+  {
+    std::lock_guard lock(registry_mutex);
+
+    auto& registered = registry[db];
+
+    if (!registered) {
+      registered = std::make_shared<fl::stmt_profiler>();
+    }
+
+    profiler = registered;
+  }
+
+  // NOTE: Not under `registry_mutex`, this takes the connection's mutex,
+  // and `find` and `trace` take `registry_mutex` while SQLite holds it.
+  std::call_once(profiler->installed_, [db, &profiler] {
+    fl::api(sqlite3_trace_v2,
+            { SQLITE_OK },
+            db,
+            db,
+            SQLITE_TRACE_PROFILE | SQLITE_TRACE_CLOSE,
+            &fl::stmt_profiler::trace,
+            profiler.get());
+  });
+
+  return profiler;
+}
+
+std::shared_ptr<fl::stmt_profiler>
+fl::stmt_profiler::find(sqlite3* db)
+{
+  std::lock_guard lock(registry_mutex);
+
+  auto it = registry.find(db);
+
+  return it == registry.end() ? nullptr : it->second;
+}
+
+int
+fl::stmt_profiler::trace(unsigned int type, void* context, void* p, void* x)
+{
+  if (SQLITE_TRACE_CLOSE == type) {
+    std::lock_guard lock(registry_mutex);
+    registry.erase(static_cast<sqlite3*>(p));
+    return 0;
+  }
+
+  auto profiler = static_cast<fl::stmt_profiler*>(context);
+
+  profiler->record(static_cast<sqlite3_stmt*>(p),
+                   *static_cast<sqlite3_int64*>(x));
+
+  return 0;
+}
+
+void
+fl::stmt_profiler::record(sqlite3_stmt* stmt, uint64_t const ns)
+{
+  auto sql = fl::api(sqlite3_sql, nullptr, stmt);
+
+  // NOTE: Handles are finalized without notice and their addresses get
+  // reused, so keeping the last values per handle to compute differences
+  // does not work; resetting does.
+  auto run = fl::stmt_status::of(stmt, true);
+
+  std::lock_guard lock(mutex_);
+
+  auto& e = entries_[sql ? sql : ""];
+
+  if (e.sql.empty() && sql) {
+    e.sql = sql;
+  }
+
+  e.runs++;
+  e.total_ns += ns;
+  e.max_ns = std::max(e.max_ns, ns);
+  e.histogram[ns ? std::bit_width(ns) - 1 : 0]++;
+
+  e.counters.fullscan_steps += run.fullscan_steps;
+  e.counters.sorts += run.sorts;
+  e.counters.autoindex += run.autoindex;
+  e.counters.vm_steps += run.vm_steps;
+  e.counters.reprepares += run.reprepares;
+  e.counters.runs += run.runs;
+  e.counters.memory_used = std::max(e.counters.memory_used, run.memory_used);
+}
+
+std::vector<fl::stmt_profiler::entry>
+fl::stmt_profiler::snapshot() const
+{
+  std::lock_guard lock(mutex_);
+
+  std::vector<fl::stmt_profiler::entry> result;
+  result.reserve(entries_.size());
+
+  for (auto&& [sql, e] : entries_) {
+    result.push_back(e);
+  }
+
+  return result;
+}
+
+void
+fl::stmt_profiler::clear()
+{
+  std::lock_guard lock(mutex_);
+  entries_.clear();
+}
+
+uint64_t
+fl::stmt_profiler::entry::percentile_ns(double const q) const
+{
+  uint64_t cumulative = 0;
+
+  for (size_t ix = 0; ix < histogram.size(); ++ix) {
+    cumulative += histogram[ix];
+
+    if (cumulative > 0 && cumulative >= q * runs) {
+      return ix < 63 ? (uint64_t(1) << (ix + 1)) : UINT64_MAX;
+    }
+  }
+
+  return 0;
+}
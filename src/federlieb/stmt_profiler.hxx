@@ -0,0 +1,67 @@
+#ifndef FEDERLIEB_STMT_PROFILER_HXX
+#define FEDERLIEB_STMT_PROFILER_HXX
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "api.hxx"
+
+#include "federlieb/stmt.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+// Per-connection statement statistics collected through `sqlite3_trace_v2`
+// profile events, keyed by SQL text: how often each statement ran, a
+// log2 histogram of run times (first step to reset), and the summed
+// `sqlite3_stmt_status` counters. Installing takes over the connection's
+// trace callback, and since the counters are reset after every run,
+// `fl::stmt::status()` only covers the current run on such connections.
+// Profilers are found by connection handle and dropped when the
+// connection closes.
+class stmt_profiler
+{
+public:
+  struct entry
+  {
+    std::string sql;
+    uint64_t runs = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+
+    // `histogram[i]` counts runs that took [2^i, 2^(i+1)) nanoseconds.
+    std::array<uint64_t, 64> histogram{};
+
+    fl::stmt_status counters;
+
+    // Upper bound of the histogram bucket holding the `q` quantile.
+    uint64_t percentile_ns(double const q) const;
+  };
+
+  static std::shared_ptr<fl::stmt_profiler> install(sqlite3* db);
+  static std::shared_ptr<fl::stmt_profiler> find(sqlite3* db);
+
+  std::vector<entry> snapshot() const;
+  void clear();
+
+protected:
+  static int trace(unsigned int type, void* context, void* p, void* x);
+
+  void record(sqlite3_stmt* stmt, uint64_t const ns);
+
+  // Set once the trace callback is installed on the connection.
+  std::once_flag installed_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, entry> entries_;
+};
+
+}
+
+#endif
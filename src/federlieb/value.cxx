@@ -118,6 +118,110 @@ fl::value::from(sqlite3_value* value)
   }
 }
 
+fl::value::view
+fl::value::borrow(sqlite3_value* value)
+{
+  // NOTE: must not be used on unprotected sqlite3_value
+  switch (sqlite3_value_type(value)) {
+    case SQLITE_INTEGER:
+      return fl::value::integer{ sqlite3_value_int64(value) };
+    case SQLITE_FLOAT:
+      return fl::value::real{ sqlite3_value_double(value) };
+    case SQLITE_TEXT: {
+      auto data = sqlite3_value_text(value);
+      fl::error::raise_if(nullptr == data, "allocation problem");
+      auto length = sqlite3_value_bytes(value);
+      auto str = std::string_view(reinterpret_cast<const char*>(data), length);
+      if ('J' == sqlite3_value_subtype(value)) {
+        return fl::value::json_view{ str };
+      }
+      return fl::value::text_view{ str };
+    }
+    case SQLITE_BLOB: {
+      auto data = static_cast<const std::byte*>(sqlite3_value_blob(value));
+      auto length = sqlite3_value_bytes(value);
+      // NOTE: zero-length BLOBs may come back as nullptr.
+      fl::error::raise_if(nullptr == data && length > 0, "allocation problem");
+      return fl::value::blob_view{ std::span<const std::byte>(data, length) };
+    }
+    case SQLITE_NULL:
+      return fl::value::null{};
+    default:
+      fl::error::raise("unsupported sqlite3_value_type");
+  }
+}
+
+fl::value::variant
+fl::value::from(const fl::value::view& value)
+{
+  return std::visit(
+    [](auto&& e) -> fl::value::variant {
+      using T = std::decay_t<decltype(e)>;
+      if constexpr (std::same_as<T, fl::value::text_view>) {
+        return fl::value::text{ std::string(e.value) };
+      } else if constexpr (std::same_as<T, fl::value::json_view>) {
+        return fl::value::json{ std::string(e.value) };
+      } else if constexpr (std::same_as<T, fl::value::blob_view>) {
+        return fl::value::blob{ fl::blob_type(e.value.begin(), e.value.end()) };
+      } else {
+        return e;
+      }
+    },
+    value);
+}
+
+namespace {
+
+// Same order as `operator<=>` on `fl::value::variant`.
+std::partial_ordering
+compare(const fl::value::variant& lhs, const fl::value::view& rhs)
+{
+  if (lhs.index() != rhs.index()) {
+    return lhs.index() <=> rhs.index();
+  }
+
+  return std::visit(
+    [&rhs](auto&& e) -> std::partial_ordering {
+      using T = std::decay_t<decltype(e)>;
+      if constexpr (std::same_as<T, fl::value::null>) {
+        return std::partial_ordering::equivalent;
+      } else if constexpr (std::same_as<T, fl::value::text>) {
+        return std::string_view(e.value) <=>
+               std::get<fl::value::text_view>(rhs).value;
+      } else if constexpr (std::same_as<T, fl::value::json>) {
+        return std::string_view(e.value) <=>
+               std::get<fl::value::json_view>(rhs).value;
+      } else if constexpr (std::same_as<T, fl::value::blob>) {
+        auto&& other = std::get<fl::value::blob_view>(rhs).value;
+        return std::lexicographical_compare_three_way(
+          e.value.begin(), e.value.end(), other.begin(), other.end());
+      } else {
+        return e.value <=> std::get<T>(rhs).value;
+      }
+    },
+    lhs);
+}
+
+}
+
+bool
+fl::value::operator<(const fl::value::variant& lhs, const fl::value::view& rhs)
+{
+  return compare(lhs, rhs) < 0;
+}
+
+bool
+fl::value::operator<(const fl::value::view& lhs, const fl::value::variant& rhs)
+{
+  return compare(rhs, lhs) > 0;
+}
+
+bool
+fl::value::operator==(const fl::value::variant& lhs, const fl::value::view& rhs)
+{
+  return compare(lhs, rhs) == 0;
+}
+
 void
 fl::value::coercion::operator()(sqlite3_value* const value, double& sink)
 {
@@ -167,3 +271,10 @@ fl::value::coercion::operator()(sqlite3_value* const value,
 {
   sink = fl::value::from(value);
 }
+
+void
+fl::value::coercion::operator()(sqlite3_value* const value,
+                                fl::value::view& sink)
+{
+  sink = fl::value::borrow(value);
+}
@@ -1,6 +1,8 @@
 #ifndef FEDERLIEB_VALUE_HXX
 #define FEDERLIEB_VALUE_HXX
 
+#include <span>
+#include <string_view>
 #include <variant>
 
 #include "api.hxx"
@@ -66,6 +68,39 @@ operator<<(std::ostream& os, const blob& v);
 
 using variant = std::variant<null, integer, real, text, blob, json>;
 
+struct text_view
+{
+  std::string_view value;
+};
+
+struct blob_view
+{
+  std::span<const std::byte> value;
+};
+
+struct json_view
+{
+  std::string_view value;
+};
+
+// Non-owning counterpart of `variant`, with the alternatives in the same
+// order. TEXT and BLOB payloads point into memory owned by SQLite and are
+// only valid as long as the value they were taken from, usually until the
+// next step of a statement or the end of a callback. `from` turns a `view`
+// into an owning `variant`. The two can be compared with each other, so a
+// `view` can be looked up in containers keyed by `variant` that use
+// `std::less<>`.
+using view = std::variant<null, integer, real, text_view, blob_view, json_view>;
+
+bool
+operator<(const variant& lhs, const view& rhs);
+
+bool
+operator<(const view& lhs, const variant& rhs);
+
+bool
+operator==(const variant& lhs, const view& rhs);
+
 template<std::integral T>
 inline variant
 from(const T& value)
@@ -88,6 +123,14 @@ from(const nullptr_t& value);
 variant
 from(sqlite3_value* value);
 
+variant
+from(const view& value);
+
+// Like `from(sqlite3_value*)`, but without copying TEXT and BLOB values.
+// NOTE: must not be used on unprotected sqlite3_value
+view
+borrow(sqlite3_value* value);
+
 template<typename T>
 inline variant
 from(const std::optional<T>& value)
@@ -114,6 +157,8 @@ struct coercion
   void operator()(sqlite3_value* const value, fl::value::blob& sink);
   // NOTE: must not be used on unprotected value
   void operator()(sqlite3_value* const value, fl::value::variant& sink);
+  // NOTE: must not be used on unprotected value
+  void operator()(sqlite3_value* const value, fl::value::view& sink);
 
   template<typename T>
   inline void operator()(sqlite3_value* const value, std::optional<T>& sink)
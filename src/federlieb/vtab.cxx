@@ -1,19 +1,13 @@
 #include <boost/algorithm/hex.hpp>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 
 #include "federlieb/federlieb.hxx"
 #include "federlieb/vtab.hxx"
 
 namespace fl = ::federlieb;
 
-// TODO: Instead of encoding xBestIndex information as JSON in idxStr, make use
-// of the fact that SQLite considers a return value of SQLITE_CONSTRAINT from
-// xFilter a sign that xBestIndex needs to be run again (because the scheme may
-// have changed since preparing the statement) and does so for a configurable
-// number of times (SQLITE_MAX_SCHEMA_RETRY) when using `sqlite3_prepare_v2`.
-// We can then simply record the last couple of xBestIndex data sets and report
-// a counter value in idxNum as identifier. Return an error when the idxNum has
-// become invalid and hope SQLite will re-prepare the statement.
-
 std::string
 fl::vtab::to_sql(const fl::value::null& v)
 {
@@ -55,6 +49,12 @@ fl::vtab::to_sql(const fl::value::blob& v)
   return "X'" + out + "'";
 }
 
+std::string
+fl::vtab::to_sql(const fl::value::json& v)
+{
+  return to_sql(fl::value::text{ v.value });
+}
+
 std::string
 fl::vtab::to_sql(const fl::value::variant& v)
 {
@@ -104,12 +104,25 @@ fl::vtab::to_sql(const fl::vtab::constraint_info& constraint,
 {
 
   fl::error::raise_if(include_collation, "unimplemented");
-  fl::error::raise_if(constraint.many_at_once.value_or(false), "unimplemented");
+
+  if (constraint.many_at_once.value_or(false)) {
+    std::string list;
+    for (auto&& value : constraint.current_list) {
+      list += (list.empty() ? "" : ", ") + to_sql(value);
+    }
+    return "IN (" + list + ")";
+  }
 
   auto op_str = constraint_op_to_string(constraint.op);
 
-  if ((constraint.current_value.has_value()) && nullptr != op_str) {
-    return std::string(op_str) + " " + to_sql(constraint.current_value.value());
+  // NOTE: these have no right-hand side, SQLite passes NULL.
+  if (SQLITE_INDEX_CONSTRAINT_ISNULL == constraint.op ||
+      SQLITE_INDEX_CONSTRAINT_ISNOTNULL == constraint.op) {
+    return op_str;
+  }
+
+  if ((constraint.current_view.has_value()) && nullptr != op_str) {
+    return std::string(op_str) + " " + to_sql(constraint.current_value().value());
   }
 
   return "";
@@ -194,6 +207,82 @@ fl::vtab::index_info::get(const std::string& name, int const op) const
   return nullptr;
 }
 
+void
+fl::vtab::index_info::mark_in_lists(const std::string& name)
+{
+  for (auto&& column : columns) {
+    if (column.column_name == name) {
+      for (auto&& constraint : column.constraints) {
+        // NOTE: index_info_import sets `many_at_once` only for IN lists
+        // SQLite can pass at once.
+        if (constraint.usable && constraint.argv_index &&
+            constraint.many_at_once.has_value()) {
+          constraint.many_at_once = true;
+        }
+      }
+    }
+  }
+}
+
+bool
+fl::vtab::index_info::mark_limit()
+{
+  // NOTE: SQLite rejects the plan otherwise, as it would have to remove
+  // rows after the virtual table stopped producing them.
+  if (!limit_constraint || !limit_constraint->usable) {
+    return false;
+  }
+
+  for (auto&& column : columns) {
+    if (column.order_by_pos && !order_by_consumed) {
+      return false;
+    }
+
+    for (auto&& constraint : column.constraints) {
+      if (!constraint.argv_index || constraint.many_at_once == false) {
+        return false;
+      }
+    }
+  }
+
+  limit_constraint->argv_index = next_argv_index++;
+
+  if (offset_constraint && offset_constraint->usable) {
+    offset_constraint->argv_index = next_argv_index++;
+  }
+
+  return true;
+}
+
+std::optional<int64_t>
+fl::vtab::index_info::rows_wanted() const
+{
+  // NOTE: a negative LIMIT means no limit, a negative OFFSET none.
+  if (!limit || *limit < 0) {
+    return std::nullopt;
+  }
+
+  auto skipped = std::max(offset.value_or(0), int64_t(0));
+
+  if (*limit > std::numeric_limits<int64_t>::max() - skipped) {
+    return std::nullopt;
+  }
+
+  return *limit + skipped;
+}
+
+bool
+fl::vtab::index_info::used(const std::string& name) const
+{
+  for (auto&& column : columns) {
+    if (column.column_name == name) {
+      return column.used;
+    }
+  }
+
+  fl::error::raise("unknown column");
+}
+
 void
 fl::vtab::index_info_export(const fl::vtab::index_info& ours,
                             sqlite3_index_info* theirs)
@@ -235,6 +324,14 @@ fl::vtab::index_info_export(const fl::vtab::index_info& ours,
       }
     }
   }
+
+  // NOTE: never omitted, SQLite still applies LIMIT and OFFSET itself.
+  for (auto&& con : { ours.limit_constraint, ours.offset_constraint }) {
+    if (con && con->argv_index) {
+      theirs->aConstraintUsage[con->id].argvIndex =
+        fl::detail::safe_to<int>(*con->argv_index);
+    }
+  }
 }
 
 fl::vtab::index_info
@@ -259,8 +356,10 @@ fl::vtab::index_info_import(std::vector<fl::vtab::column> columns_,
   }
 
   if (sqlite3_libversion_number() >= 3010000) {
-    for (size_t ix = 0; ix < std::min(size_t(63), columns_.size() - 1); ++ix) {
-      ours.columns[ix + 1].used = theirs->colUsed & (1 << (ix));
+    // NOTE: the last bit stands for all columns from the 64th on.
+    for (size_t ix = 0; ix + 1 < columns_.size(); ++ix) {
+      ours.columns[ix + 1].used =
+        theirs->colUsed & (sqlite3_uint64(1) << std::min(ix, size_t(63)));
     }
   }
 
@@ -281,14 +380,6 @@ fl::vtab::index_info_import(std::vector<fl::vtab::column> columns_,
 
   for (auto ix = 0; ix < theirs->nConstraint; ++ix) {
 
-    switch (theirs->aConstraint[ix].op) {
-      case SQLITE_INDEX_CONSTRAINT_LIMIT:
-        continue;
-      case SQLITE_INDEX_CONSTRAINT_OFFSET:
-        continue;
-    }
-
-    auto&& column = ours.columns[theirs->aConstraint[ix].iColumn + 1];
     fl::vtab::constraint_info con;
 
     con.id = ix;
@@ -317,6 +408,17 @@ fl::vtab::index_info_import(std::vector<fl::vtab::column> columns_,
       }
     }
 
+    switch (con.op) {
+      case SQLITE_INDEX_CONSTRAINT_LIMIT:
+        ours.limit_constraint = con;
+        continue;
+      case SQLITE_INDEX_CONSTRAINT_OFFSET:
+        ours.offset_constraint = con;
+        continue;
+    }
+
+    auto&& column = ours.columns[theirs->aConstraint[ix].iColumn + 1];
+
     column.constraints.push_back(con);
     column.used = true;
   }
@@ -350,7 +452,8 @@ fl::vtab::mark_constraints(std::vector<fl::vtab::column> columns_,
     if ((columns_[ix].required || columns_[ix].hidden) && has_eq) {
       ours.columns[ix].constraints[0].argv_index = ours.next_argv_index++;
 
-    } else if (columns_[ix].required) {
+    } else if (columns_[ix].required &&
+               !ours.columns[ix].constraints.empty()) {
 
       return false;
     }
@@ -358,3 +461,369 @@ fl::vtab::mark_constraints(std::vector<fl::vtab::column> columns_,
 
   return true;
 }
+
+bool
+fl::vtab::missing_required(const std::vector<fl::vtab::column>& columns_,
+                           const fl::vtab::index_info& ours)
+{
+  for (size_t ix = 0; ix < ours.columns.size(); ++ix) {
+    if (columns_[ix].required &&
+        std::ranges::none_of(ours.columns[ix].constraints, [](auto&& e) {
+          return e.argv_index.has_value();
+        })) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+namespace {
+
+// Numbers are written in decimal followed by a space, strings with their
+// length first, TEXT and BLOB values in hex, and optionals as `-` when
+// empty or `+` and the value.
+class plan_writer
+{
+public:
+  std::string out;
+
+  void integer(int64_t const value)
+  {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+    out.push_back(' ');
+  }
+
+  void real(double const value)
+  {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+    out.push_back(' ');
+  }
+
+  void string(std::string_view const value)
+  {
+    integer(fl::detail::safe_to<int64_t>(value.size()));
+    out.append(value);
+  }
+
+  template<typename T>
+  void hex(const T& value)
+  {
+    auto p = reinterpret_cast<char const*>(value.data());
+    integer(fl::detail::safe_to<int64_t>(value.size()));
+    boost::algorithm::hex(p, p + value.size(), std::back_inserter(out));
+  }
+
+  void variant(const fl::value::variant& value)
+  {
+    out.push_back(static_cast<char>('0' + value.index()));
+
+    std::visit(
+      [this](auto&& v) {
+        using T = std::decay_t<decltype(v)>;
+
+        if constexpr (std::is_same_v<T, fl::value::integer>) {
+          integer(v.value);
+        } else if constexpr (std::is_same_v<T, fl::value::real>) {
+          real(v.value);
+        } else if constexpr (!std::is_same_v<T, fl::value::null>) {
+          hex(v.value);
+        }
+      },
+      value);
+  }
+
+  template<typename T, typename F>
+  void optional(const std::optional<T>& value, F&& f)
+  {
+    if (!value) {
+      out.push_back('-');
+    } else {
+      out.push_back('+');
+      f(*value);
+    }
+  }
+};
+
+class plan_reader
+{
+public:
+  explicit plan_reader(std::string_view const in)
+    : in_(in)
+  {}
+
+  template<typename T = int64_t>
+  T integer()
+  {
+    int64_t value = 0;
+    auto result = std::from_chars(in_.data(), in_.data() + in_.size(), value);
+    check(result.ec == std::errc() && result.ptr < in_.data() + in_.size());
+    in_.remove_prefix(result.ptr - in_.data() + 1);
+    return fl::detail::safe_to<T>(value);
+  }
+
+  bool boolean() { return 0 != integer(); }
+
+  double real()
+  {
+    double value = 0;
+    auto result = std::from_chars(in_.data(), in_.data() + in_.size(), value);
+    check(result.ec == std::errc() && result.ptr < in_.data() + in_.size());
+    in_.remove_prefix(result.ptr - in_.data() + 1);
+    return value;
+  }
+
+  std::string string()
+  {
+    auto size = integer<size_t>();
+    check(size <= in_.size());
+    auto result = std::string(in_.substr(0, size));
+    in_.remove_prefix(size);
+    return result;
+  }
+
+  std::string hex()
+  {
+    auto size = integer<size_t>();
+    check(2 * size <= in_.size());
+    std::string result;
+    boost::algorithm::unhex(
+      in_.begin(), in_.begin() + 2 * size, std::back_inserter(result));
+    in_.remove_prefix(2 * size);
+    return result;
+  }
+
+  fl::value::variant variant()
+  {
+    check(!in_.empty());
+    auto index = in_.front() - '0';
+    in_.remove_prefix(1);
+
+    switch (index) {
+      case 0:
+        return fl::value::null{};
+      case 1:
+        return fl::value::integer{ integer() };
+      case 2:
+        return fl::value::real{ real() };
+      case 3:
+        return fl::value::text{ hex() };
+      case 4: {
+        auto bytes = hex();
+        auto p = reinterpret_cast<std::byte const*>(bytes.data());
+        return fl::value::blob{ fl::blob_type(p, p + bytes.size()) };
+      }
+      case 5:
+        return fl::value::json{ hex() };
+    }
+
+    fl::error::raise("bad plan encoding");
+  }
+
+  template<typename F>
+  auto optional(F&& f) -> std::optional<decltype(f())>
+  {
+    check(!in_.empty());
+    auto present = '+' == in_.front();
+    in_.remove_prefix(1);
+
+    if (!present) {
+      return std::nullopt;
+    }
+
+    return f();
+  }
+
+  bool done() const { return in_.empty(); }
+
+protected:
+  static void check(bool const ok)
+  {
+    fl::error::raise_if(!ok, "bad plan encoding");
+  }
+
+  std::string_view in_;
+};
+
+}
+
+std::string
+fl::vtab::index_info_encode(const fl::vtab::index_info& info)
+{
+  plan_writer w;
+
+  auto integer = [&w](auto&& e) { w.integer(e); };
+
+  w.integer(info.distinct_mode);
+  w.integer(info.unique);
+  w.integer(info.estimated_rows);
+  w.real(info.estimated_cost);
+  w.integer(info.order_by_consumed);
+  w.integer(fl::detail::safe_to<int64_t>(info.next_argv_index));
+  auto constraint = [&w, &integer](const fl::vtab::constraint_info& e) {
+    w.integer(fl::detail::safe_to<int64_t>(e.id));
+    w.integer(e.op);
+    w.integer(e.usable);
+    w.integer(e.omit_check);
+    w.optional(e.argv_index, [&w](auto&& e) {
+      w.integer(fl::detail::safe_to<int64_t>(e));
+    });
+    w.optional(e.many_at_once, integer);
+    w.optional(e.rhs, [&w](auto&& e) { w.variant(e); });
+    w.string(e.collation);
+  };
+
+  w.optional(info.offset, integer);
+  w.optional(info.limit, integer);
+  w.optional(info.offset_constraint, constraint);
+  w.optional(info.limit_constraint, constraint);
+  w.integer(fl::detail::safe_to<int64_t>(info.columns.size()));
+
+  for (auto&& column : info.columns) {
+    w.integer(column.column_index);
+    w.string(column.column_name);
+    w.integer(column.used);
+    w.optional(column.order_by_pos,
+               [&w](auto&& e) { w.integer(fl::detail::safe_to<int64_t>(e)); });
+    w.optional(column.order_by_desc, integer);
+    w.integer(fl::detail::safe_to<int64_t>(column.constraints.size()));
+
+    for (auto&& e : column.constraints) {
+      constraint(e);
+    }
+  }
+
+  return std::move(w.out);
+}
+
+fl::vtab::index_info
+fl::vtab::index_info_decode(std::string_view const encoded)
+{
+  plan_reader r(encoded);
+  fl::vtab::index_info info = {};
+
+  info.distinct_mode = r.integer<int>();
+  info.unique = r.boolean();
+  info.estimated_rows = r.integer<long long int>();
+  info.estimated_cost = r.real();
+  info.order_by_consumed = r.boolean();
+  info.next_argv_index = r.integer<size_t>();
+  auto constraint = [&r] {
+    fl::vtab::constraint_info e = {};
+    e.id = r.integer<size_t>();
+    e.op = r.integer<int>();
+    e.usable = r.boolean();
+    e.omit_check = r.boolean();
+    e.argv_index = r.optional([&r] { return r.integer<size_t>(); });
+    e.many_at_once = r.optional([&r] { return r.boolean(); });
+    e.rhs = r.optional([&r] { return r.variant(); });
+    e.collation = r.string();
+    e.current_raw = nullptr;
+    return e;
+  };
+
+  info.offset = r.optional([&r] { return r.integer<int64_t>(); });
+  info.limit = r.optional([&r] { return r.integer<int64_t>(); });
+  info.offset_constraint = r.optional(constraint);
+  info.limit_constraint = r.optional(constraint);
+  info.columns.resize(r.integer<size_t>());
+
+  for (auto&& column : info.columns) {
+    column.column_index = r.integer<int>();
+    column.column_name = r.string();
+    column.used = r.boolean();
+    column.order_by_pos = r.optional([&r] { return r.integer<size_t>(); });
+    column.order_by_desc = r.optional([&r] { return r.boolean(); });
+    column.constraints.resize(r.integer<size_t>());
+
+    for (auto&& e : column.constraints) {
+      e = constraint();
+    }
+  }
+
+  fl::error::raise_if(!r.done(), "bad plan encoding");
+  fl::error::raise_if(index_info_encode(info) != encoded, "bad plan encoding");
+
+  return info;
+}
+
+bool
+fl::vtab::debug_plans()
+{
+  static bool const result = nullptr != std::getenv("FEDERLIEB_DEBUG_PLANS");
+  return result;
+}
+
+bool
+fl::vtab::has_blob_rhs(const fl::vtab::index_info& info)
+{
+  auto is_blob = [](const std::optional<fl::vtab::constraint_info>& e) {
+    return e && e->rhs && std::holds_alternative<fl::value::blob>(*e->rhs);
+  };
+
+  for (auto&& column : info.columns) {
+    for (auto&& constraint : column.constraints) {
+      if (is_blob(constraint)) {
+        return true;
+      }
+    }
+  }
+
+  return is_blob(info.offset_constraint) || is_blob(info.limit_constraint);
+}
+
+fl::vtab::plan_registry::plan_registry()
+{
+  auto value = std::getenv("FEDERLIEB_PLAN_CAPACITY");
+
+  if (nullptr == value) {
+    return;
+  }
+
+  auto end = value + std::strlen(value);
+  auto result = std::from_chars(value, end, capacity_);
+
+  fl::error::raise_if(result.ec != std::errc() || result.ptr != end,
+                      "FEDERLIEB_PLAN_CAPACITY must be a number");
+}
+
+int
+fl::vtab::plan_registry::add(const fl::vtab::index_info& info,
+                             const std::string& encoded)
+{
+  auto it = ids_.find(encoded);
+
+  if (it != ids_.end()) {
+    return it->second;
+  }
+
+  // NOTE: statements prepared earlier may still use forgotten plans, ids
+  // keep increasing so those are never confused with new ones.
+  if (plans_.size() >= capacity_) {
+    ids_.clear();
+    plans_.clear();
+  }
+
+  fl::error::raise_if(last_id_ == std::numeric_limits<int>::max(),
+                      "too many plans");
+
+  auto id = ++last_id_;
+
+  if (capacity_ > 0) {
+    ids_.emplace(encoded, id);
+    plans_.emplace(id, info);
+  }
+
+  return id;
+}
+
+fl::vtab::index_info const*
+fl::vtab::plan_registry::find(int const id) const
+{
+  auto it = plans_.find(id);
+  return it == plans_.end() ? nullptr : &it->second;
+}
@@ -2,14 +2,21 @@
 #define FEDERLIEB_VTAB_HXX
 
 #include <chrono>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 #include <variant>
 #include <vector>
-#include <array>
 
 #include <boost/json.hpp>
+#include <boost/pfr.hpp>
 
 #include "federlieb/concepts.hxx"
 #include "federlieb/context.hxx"
@@ -33,8 +40,32 @@ struct constraint_info
   std::optional<bool> many_at_once;
   std::optional<fl::value::variant> rhs;
   std::string collation;
-  std::optional<fl::value::variant> current_value;
   sqlite3_value* current_raw;
+  // Only valid during xFilter, see `fl::value::view`.
+  std::optional<fl::value::view> current_view;
+  // The distinct values of an IN list processed `many_at_once`, instead of
+  // `current_view`. Only valid during xFilter.
+  std::vector<fl::value::variant> current_list;
+
+  std::optional<fl::value::variant> current_value() const
+  {
+    if (!current_view) {
+      return std::nullopt;
+    }
+    return fl::value::from(*current_view);
+  }
+
+  // All values the column may have, the IN list or the current value.
+  std::vector<fl::value::variant> current_values() const
+  {
+    if (many_at_once.value_or(false)) {
+      return current_list;
+    }
+    if (!current_view) {
+      return {};
+    }
+    return { fl::value::from(*current_view) };
+  }
 };
 
 struct column_info
@@ -50,8 +81,14 @@ struct column_info
 struct index_info
 {
   std::vector<column_info> columns;
-  std::optional<int> offset;
-  std::optional<int> limit;
+  // OFFSET and LIMIT of the statement, only set during xFilter and only
+  // after `mark_limit`.
+  std::optional<int64_t> offset;
+  std::optional<int64_t> limit;
+  // The constraints SQLite offers for them, for statements on this table
+  // alone.
+  std::optional<constraint_info> offset_constraint;
+  std::optional<constraint_info> limit_constraint;
   int distinct_mode;
   bool unique;
   long long int estimated_rows;
@@ -62,6 +99,26 @@ struct index_info
   void mark_wanted(const std::string& name, int const op);
   void mark_transferables(const std::string& column_name);
   constraint_info const* get(const std::string& name, int const op) const;
+
+  // Asks for an IN list on column `name` to be passed to one xFilter call,
+  // see `constraint_info::current_list`, where SQLite allows it. Otherwise
+  // SQLite calls xFilter once for each value. Only for constraints that
+  // have an `argv_index`.
+  void mark_in_lists(const std::string& name);
+
+  // Asks for the LIMIT and OFFSET values, for xBestIndex of modules that
+  // can stop after `rows_wanted()` rows. Must come last, as SQLite allows
+  // it only when all other constraints have an `argv_index`, IN lists are
+  // passed at once, and there is no ORDER BY or it is consumed. Returns
+  // whether that is the case. SQLite still applies LIMIT and OFFSET.
+  bool mark_limit();
+
+  // OFFSET plus LIMIT, or nothing when there is no limit.
+  std::optional<int64_t> rows_wanted() const;
+
+  // Whether the statement reads column `name` or has constraints on it.
+  // xFilter can skip work for the others, SQLite never asks for them.
+  bool used(const std::string& name) const;
 };
 
 struct column
@@ -73,6 +130,27 @@ struct column
   bool required;
 };
 
+// A row changed by INSERT, UPDATE or DELETE on a writable virtual table,
+// see `base`.
+struct change
+{
+  enum class operation
+  {
+    insert,
+    update,
+    remove
+  };
+
+  operation op;
+  // The rowid before and after the change. An INSERT may leave choosing
+  // the rowid to xUpdate.
+  std::optional<sqlite3_int64> old_rowid;
+  std::optional<sqlite3_int64> new_rowid;
+  // Values of all declared columns, including hidden ones, but none for
+  // DELETE.
+  std::vector<fl::value::variant> values;
+};
+
 std::string
 to_sql(const fl::value::null& v);
 
@@ -88,6 +166,10 @@ to_sql(const fl::value::text& v);
 std::string
 to_sql(const fl::value::blob& v);
 
+// As TEXT, SQL literals have no subtype.
+std::string
+to_sql(const fl::value::json& v);
+
 std::string
 to_sql(const fl::value::variant& v);
 
@@ -109,6 +191,56 @@ bool
 mark_constraints(std::vector<fl::vtab::column> columns_,
                  fl::vtab::index_info& ours);
 
+// Whether a VT_REQUIRED column has no value in the plan. SQLite drops
+// `x IN ()` from the WHERE clause, which is then constant false, so such
+// plans are offered at a prohibitive cost instead of being rejected, and
+// xFilter raises should SQLite use one anyway.
+bool
+missing_required(const std::vector<fl::vtab::column>& columns_,
+                 const fl::vtab::index_info& ours);
+
+// Compact encoding of everything in `index_info` except the values only
+// valid during xFilter. It contains no NUL bytes, so it can be passed as
+// `idxStr`.
+std::string
+index_info_encode(const fl::vtab::index_info& info);
+
+// Raises unless `encoded` is exactly what `index_info_encode` gives for
+// the result, so no field is lost silently.
+fl::vtab::index_info
+index_info_decode(std::string_view const encoded);
+
+// Set the environment variable FEDERLIEB_DEBUG_PLANS to log each plan
+// and pass it as JSON in `idxStr`, where EXPLAIN shows it. Plans with
+// BLOB values, which JSON cannot hold, keep the compact encoding.
+bool
+debug_plans();
+
+bool
+has_blob_rhs(const fl::vtab::index_info& info);
+
+// The plans xBestIndex produced for one virtual table, by `idxNum`. Ids
+// are never reused, and equal plans share one. Old plans are forgotten
+// once there are too many, xFilter then decodes the plan from `idxStr`.
+class plan_registry
+{
+public:
+  // The environment variable FEDERLIEB_PLAN_CAPACITY overrides how many
+  // plans are kept, 0 keeps none, so xFilter always decodes `idxStr`.
+  plan_registry();
+
+  int add(const fl::vtab::index_info& info, const std::string& encoded);
+
+  // `nullptr` for unknown ids.
+  fl::vtab::index_info const* find(int const id) const;
+
+protected:
+  size_t capacity_ = 1024;
+  int last_id_ = 0;
+  std::unordered_map<std::string, int> ids_;
+  std::unordered_map<int, fl::vtab::index_info> plans_;
+};
+
 std::string
 usable_constraints_to_where_fragment(const std::string& table_name,
                                      const fl::vtab::index_info& info);
@@ -130,11 +262,236 @@ static_assert(
 static_assert(
   std::is_standard_layout_v<typename fl::vtab::standard_layout_cursor>);
 
+// Hands one value of an xFilter result to SQLite. Pointers are for values
+// that stay unchanged until the cursor is closed, like those owned by the
+// cursor or the virtual table, SQLite does not copy them; `nullptr` is
+// NULL.
+template<typename T>
+void
+result_value(fl::context& context, const T& value)
+{
+  if constexpr (std::is_pointer_v<T>) {
+    if (nullptr == value) {
+      context.result(nullptr);
+    } else {
+      context.result_static(*value);
+    }
+  } else {
+    context.result(value);
+  }
+}
+
+// Field `column` of a row given as aggregate, see Boost.PFR.
+template<typename Row>
+void
+result_field(fl::context& context, const Row& row, int const column)
+{
+  boost::pfr::for_each_field(row, [&](const auto& field, size_t ix) {
+    if (size_t(column) == ix) {
+      result_value(context, field);
+    }
+  });
+}
+
+// The same value in every row of a `columns` result.
+template<typename T>
+struct constant
+{
+  T value;
+};
+
+// Values of a `columns` result computed by `f(row)`, only for the rows
+// and columns xColumn asks for.
+template<typename T>
+struct computed
+{
+  size_t rows = 0;
+  std::function<T(size_t)> f;
+
+  size_t size() const { return rows; }
+  T operator[](size_t const row) const { return f(row); }
+};
+
+// Columnar xFilter result, one container per declared column, including
+// hidden ones: a `std::vector` with one element per row, a `computed`
+// column, or a `constant`. All but constants must have the same size.
+// Elements are handed to SQLite by their type, see `result_value`.
+template<typename... Columns>
+class columns
+{
+public:
+  static_assert(sizeof...(Columns) > 0);
+
+  // What xColumn sees of the current row.
+  struct row_ref
+  {
+    const columns* table;
+    size_t row;
+
+    void result(fl::context& context, int const column) const
+    {
+      table->result(context, column, row);
+    }
+  };
+
+  class iterator
+  {
+  public:
+    using value_type = row_ref;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    iterator(const columns* table, size_t const row)
+      : table_(table)
+      , row_(row)
+    {}
+
+    row_ref operator*() const { return { table_, row_ }; }
+
+    iterator& operator++()
+    {
+      ++row_;
+      return *this;
+    }
+
+    void operator++(int) { ++row_; }
+
+    bool operator==(const iterator& other) const { return row_ == other.row_; }
+
+  protected:
+    const columns* table_ = nullptr;
+    size_t row_ = 0;
+  };
+
+  columns() = default;
+
+  explicit columns(Columns... columns)
+    : data_(std::move(columns)...)
+  {}
+
+  template<size_t I>
+  auto& get()
+  {
+    return std::get<I>(data_);
+  }
+
+  size_t size() const
+  {
+    std::optional<size_t> result;
+
+    std::apply(
+      [&](const auto&... column) {
+        (
+          [&] {
+            if constexpr (!is_constant<std::decay_t<decltype(column)>>) {
+              fl::error::raise_if(result && *result != column.size(),
+                                  "columns differ in size");
+              result = column.size();
+            }
+          }(),
+          ...);
+      },
+      data_);
+
+    return result.value_or(0);
+  }
+
+  iterator begin() const { return { this, 0 }; }
+  iterator end() const { return { this, size() }; }
+
+  void result(fl::context& context, int const column, size_t const row) const
+  {
+    [&]<size_t... Is>(std::index_sequence<Is...>)
+    {
+      ((size_t(column) == Is ? result_cell(context, std::get<Is>(data_), row)
+                             : void()),
+       ...);
+    }
+    (std::index_sequence_for<Columns...>{});
+  }
+
+protected:
+  template<typename C>
+  static constexpr bool is_constant = requires(const C& c) { c.value; };
+
+  template<typename C>
+  static void result_cell(fl::context& context, const C& column, size_t row)
+  {
+    if constexpr (is_constant<C>) {
+      result_value(context, column.value);
+    } else {
+      result_value(context, column[row]);
+    }
+  }
+
+  std::tuple<Columns...> data_;
+};
+
+// Single pass xFilter result that produces rows on demand: `next` gives
+// the next row, or nothing at the end, and is called for the first row
+// by xFilter and for the others by xNext. Only the current row is kept,
+// state `next` needs is best captured in it.
+template<typename Row>
+class generator
+{
+public:
+  using next_function = std::function<std::optional<Row>()>;
+
+  class iterator
+  {
+  public:
+    using value_type = Row;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(generator* generator)
+      : generator_(generator)
+    {}
+
+    const Row& operator*() const { return *generator_->current_; }
+
+    iterator& operator++()
+    {
+      generator_->current_ = generator_->next_();
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    bool operator==(std::default_sentinel_t) const
+    {
+      return !generator_->current_;
+    }
+
+  protected:
+    generator* generator_ = nullptr;
+  };
+
+  generator() = default;
+
+  explicit generator(next_function next)
+    : next_(std::move(next))
+  {}
+
+  iterator begin()
+  {
+    current_ = next_();
+    return iterator(this);
+  }
+
+  std::default_sentinel_t end() const { return {}; }
+
+protected:
+  next_function next_;
+  std::optional<Row> current_;
+};
+
 template<typename Vtab>
 struct base
 {
 public:
   std::shared_ptr<sqlite3> db_ = nullptr;
+  fl::db database_;
   std::vector<std::string> argv_;
 
   std::string module_name_;
@@ -142,16 +499,35 @@ public:
   std::string table_name_;
   std::vector<fl::vtab::column> columns_;
 
-  int xBestIndexCallCount_ = 0;
-  std::array<index_info, 16> index_info_cache_;
+  fl::vtab::plan_registry plans_;
+
+  // Rows changed in the current transaction, in order. Tables of a `Vtab`
+  // with `xSync(std::vector<fl::vtab::change>& batch)` are writable and get
+  // them all at once there, when SQLite commits; an error fails the commit.
+  // Optional hooks: `xUpdate(fl::vtab::change&)` for each row as it is
+  // changed, to reject it or to choose the rowid of an INSERT, and
+  // `xCommit()` and `xRollback()`, the latter also after xSync when
+  // another table failed. Until xSync, the changes are only here, and
+  // xFilter has to apply them to its rows itself, or later statements of
+  // the transaction miss them. UPDATE and DELETE find rows by rowid, so
+  // rows of writable tables should have a `rowid()`, and an INSERT
+  // without one fails unless xUpdate chooses it.
+  std::vector<fl::vtab::change> changes_;
+  // Size of `changes_` at each savepoint.
+  std::vector<size_t> savepoints_;
 
   struct cursor_state
   {
     Vtab::cursor* cursor;
-    sqlite_int64 rowid;
+    // Position of the current row, the rowid of rows without `rowid()`.
+    sqlite_int64 rowid = 0;
     decltype(std::declval<Vtab>().xFilter({}, {})) result;
     std::ranges::iterator_t<decltype(cursor_state::result)> it;
     std::ranges::sentinel_t<decltype(cursor_state::result)> end;
+
+    // The plan of the last xFilter call, usually the next one's as well.
+    int plan_id = 0;
+    fl::vtab::index_info info;
   };
 
   struct cursor_pointers
@@ -234,7 +610,10 @@ public:
             std::views::transform([](auto&& e) { return *e; }));
   }
 
-  auto db() const { return fl::db(db_); }
+  // NOTE: returns copies sharing one prepared statement cache, which is
+  // cleared when the table is disconnected. Statements that read this very
+  // table would keep it from being disconnected and must not come from it.
+  auto db() const { return database_; }
 
   std::optional<std::string> kwarg(const std::string& keyword) const
   {
@@ -335,6 +714,7 @@ protected
     *ppVTab = std::addressof(sl_vtab->base);
 
     db_ = std::shared_ptr<sqlite3>(db, [](auto) {});
+    database_ = fl::db(db_, std::make_shared<fl::stmt_cache>());
     argv_ = std::vector<std::string>(argv, argv + argc);
     module_name_ = argv_.at(0);
     schema_name_ = argv_.at(1);
@@ -399,6 +779,9 @@ public:
           p.vtab->xDisconnect(true);
         }
 
+        // Before SQLite checks for unfinalized statements on close.
+        p.vtab->database_.stmt_cache()->clear();
+
         delete p.vtab;
         delete p.sl_vtab;
       } catch (std::bad_alloc const& e) {
@@ -425,6 +808,9 @@ public:
           p.vtab->xDisconnect(false);
         }
 
+        // Before SQLite checks for unfinalized statements on close.
+        p.vtab->database_.stmt_cache()->clear();
+
         delete p.vtab;
         delete p.sl_vtab;
       } catch (std::bad_alloc const& e) {
@@ -467,15 +853,27 @@ public:
           return SQLITE_CONSTRAINT;
         }
 
+        if (fl::vtab::missing_required(p.vtab->columns_, ours)) {
+          ours.estimated_cost = std::numeric_limits<double>::max();
+        }
+
         // p.vtab->log("D: AFTER index_info\n{}", boost::json::serialize(boost::json::value_from(ours)));
 
         index_info_export(ours, theirs);
 
-        theirs->idxNum = ++p.vtab->xBestIndexCallCount_;
-        p.vtab->index_info_cache_[ p.vtab->xBestIndexCallCount_ % p.vtab->index_info_cache_.size() ] = ours;
+        auto serialized = fl::vtab::index_info_encode(ours);
+
+        theirs->idxNum = p.vtab->plans_.add(ours, serialized);
 
-        std::string serialized =
-          boost::json::serialize(boost::json::value_from(ours));
+        if (fl::vtab::debug_plans()) {
+          if (!fl::vtab::has_blob_rhs(ours)) {
+            serialized = boost::json::serialize(boost::json::value_from(ours));
+          }
+          p.vtab->log("D: {} plan {} {}",
+                      p.vtab->table_name_,
+                      theirs->idxNum,
+                      serialized);
+        }
 
         theirs->idxStr = static_cast<char*>(
           fl::api(sqlite3_malloc64, p.vtab->db_.get(), 1 + serialized.size()));
@@ -502,33 +900,79 @@ public:
       try {
         auto p = unbox(c);
 
-        // TODO: it would be possible to cache the object and just
-        // look it up here, possibly only parsing the JSON when the
-        // stored object has expired.
+        auto& info = p.state->info;
 
-        fl::vtab::index_info info;
-        
-        if ((idxNum - p.vtab->xBestIndexCallCount_) < p.vtab->index_info_cache_.size()) {
-          info = p.vtab->index_info_cache_[ idxNum % p.vtab->index_info_cache_.size() ];
-        } else {
-          info = boost::json::value_to<fl::vtab::index_info>(
-            boost::json::parse(idxStr));
+        if (0 == p.state->plan_id || idxNum != p.state->plan_id) {
+          if (auto plan = p.vtab->plans_.find(idxNum)) {
+            info = *plan;
+          } else if ('{' == idxStr[0]) {
+            info = boost::json::value_to<fl::vtab::index_info>(
+              boost::json::parse(idxStr));
+          } else {
+            info = fl::vtab::index_info_decode(idxStr);
+          }
+
+          p.state->plan_id = idxNum;
         }
 
+        fl::error::raise_if(fl::vtab::missing_required(p.vtab->columns_, info),
+                            "missing constraint on a required column");
+
         for (auto&& column : info.columns) {
           for (auto&& constraint : column.constraints) {
-            if (constraint.argv_index) {
-              constraint.current_raw = argv[*constraint.argv_index - 1];
-              constraint.current_value =
-                fl::value::from(constraint.current_raw);
+            if (!constraint.argv_index) {
+              continue;
+            }
+
+            constraint.current_raw = argv[*constraint.argv_index - 1];
+
+            if (!constraint.many_at_once.value_or(false)) {
+              constraint.current_view =
+                fl::value::borrow(constraint.current_raw);
+              continue;
+            }
+
+            // NOTE: SQLite reuses the value it hands out, so values are
+            // copied.
+            constraint.current_view = std::nullopt;
+            constraint.current_list.clear();
+
+            sqlite3_value* value = nullptr;
+            auto rc = fl::api(sqlite3_vtab_in_first,
+                              { SQLITE_OK, SQLITE_DONE },
+                              p.vtab->db_.get(),
+                              constraint.current_raw,
+                              &value);
+
+            while (SQLITE_OK == rc) {
+              constraint.current_list.push_back(fl::value::from(value));
+              rc = fl::api(sqlite3_vtab_in_next,
+                           { SQLITE_OK, SQLITE_DONE },
+                           p.vtab->db_.get(),
+                           constraint.current_raw,
+                           &value);
             }
           }
         }
 
+        info.offset = std::nullopt;
+        info.limit = std::nullopt;
+
+        if (info.offset_constraint && info.offset_constraint->argv_index) {
+          info.offset =
+            sqlite3_value_int64(argv[*info.offset_constraint->argv_index - 1]);
+        }
+
+        if (info.limit_constraint && info.limit_constraint->argv_index) {
+          info.limit =
+            sqlite3_value_int64(argv[*info.limit_constraint->argv_index - 1]);
+        }
+
         //        p.vtab->log("D: xFilter with {}",
         //                    fl::vtab::usable_constraints_to_where_fragment("t",
         //                    info));
 
+        p.state->rowid = 0;
         p.state->result = p.vtab->xFilter(info, p.cursor);
         p.state->end = std::ranges::end(p.state->result);
         p.state->it = std::ranges::begin(p.state->result);
@@ -602,8 +1046,16 @@ public:
 
           auto p = unbox(c);
           auto&& d = *(p.state->it);
-          auto it = d.begin() + id; // TODO: std::next?
-          fl::context(ctx, p.vtab->db_.get()).result(*it);
+          auto context = fl::context(ctx, p.vtab->db_.get());
+
+          if constexpr (requires { d.result(context, id); }) {
+            d.result(context, id);
+          } else if constexpr (std::ranges::range<decltype(d)>) {
+            auto it = d.begin() + id; // TODO: std::next?
+            context.result(*it);
+          } else {
+            fl::vtab::result_field(context, d, id);
+          }
 
         } catch (...) {
           return SQLITE_INTERNAL;
@@ -615,7 +1067,11 @@ public:
     module.xRowid = [](sqlite3_vtab_cursor* c, sqlite_int64* pRowid) noexcept {
       try {
         auto p = unbox(c);
-        *pRowid = p.state->rowid;
+        if constexpr (requires { sqlite_int64((*(p.state->it)).rowid()); }) {
+          *pRowid = (*(p.state->it)).rowid();
+        } else {
+          *pRowid = p.state->rowid;
+        }
       } catch (...) {
         return SQLITE_INTERNAL;
       }
@@ -631,54 +1087,154 @@ public:
          void (**pxFunc)(sqlite3_context*, int, sqlite3_value**),
          void** ppArg) noexcept { return SQLITE_OK; };
 
-    module.xUpdate = [](sqlite3_vtab* pVtab,
-                        int argc,
-                        sqlite3_value** argv,
-                        sqlite_int64* pRowid) noexcept {
-      try {
-        if (argc == 1 && argv[0] != nullptr) {
-          // DELETE
-        } else if (argc > 1 && argv[0] == nullptr) {
-          // INSERT
-        } else if (argc > 1 && argv[0] != nullptr && argv[0] == argv[1]) {
-          // UPDATE
-        } else if (argc > 1 && argv[0] != nullptr && argv[0] != argv[1]) {
-          // UPDATE primary key
-        } else {
+#endif
+
+    // Tables are writable when `Vtab` has the hook below, see `changes_`.
+    if constexpr (requires(Vtab* vtab, std::vector<fl::vtab::change>& batch) {
+                    vtab->xSync(batch);
+                  }) {
+
+      // NOTE: for xSavepoint and friends.
+      module.iVersion = 2;
+
+      module.xUpdate = [](sqlite3_vtab* pVTab,
+                          int argc,
+                          sqlite3_value** argv,
+                          sqlite_int64* pRowid) noexcept {
+        try {
+          auto p = unbox(pVTab);
+
+          fl::vtab::change change;
+
+          if (1 == argc) {
+            change.op = fl::vtab::change::operation::remove;
+          } else if (SQLITE_NULL == sqlite3_value_type(argv[0])) {
+            change.op = fl::vtab::change::operation::insert;
+          } else {
+            change.op = fl::vtab::change::operation::update;
+          }
+
+          if (SQLITE_NULL != sqlite3_value_type(argv[0])) {
+            change.old_rowid = sqlite3_value_int64(argv[0]);
+          }
+
+          if (argc > 1 && SQLITE_NULL != sqlite3_value_type(argv[1])) {
+            change.new_rowid = sqlite3_value_int64(argv[1]);
+          }
+
+          for (int ix = 2; ix < argc; ++ix) {
+            change.values.push_back(fl::value::from(argv[ix]));
+          }
+
+          if constexpr (requires { p.vtab->xUpdate(change); }) {
+            p.vtab->xUpdate(change);
+          }
+
+          if (change.op == fl::vtab::change::operation::insert) {
+            fl::error::raise_if(!change.new_rowid, "INSERT without rowid");
+            *pRowid = *change.new_rowid;
+          }
+
+          p.vtab->changes_.push_back(std::move(change));
+
+        } catch (std::bad_alloc const& e) {
+          return SQLITE_NOMEM;
+        } catch (...) {
+          return SQLITE_INTERNAL;
         }
 
-      } catch (std::exception const& e) {
-        return SQLITE_INTERNAL;
-      } catch (...) {
-        return SQLITE_INTERNAL;
-      }
+        return SQLITE_OK;
+      };
 
-      return SQLITE_OK;
-    };
-#endif
+      module.xBegin = [](sqlite3_vtab* pVTab) noexcept {
+        auto p = unbox(pVTab);
+        p.vtab->changes_.clear();
+        p.vtab->savepoints_.clear();
+        return SQLITE_OK;
+      };
 
-#if 0
-    module.xBegin = [](sqlite3_vtab* pVTab) noexcept { return SQLITE_OK; };
+      module.xSync = [](sqlite3_vtab* pVTab) noexcept {
+        try {
+          auto p = unbox(pVTab);
+          p.vtab->xSync(p.vtab->changes_);
+          p.vtab->changes_.clear();
+        } catch (std::bad_alloc const& e) {
+          return SQLITE_NOMEM;
+        } catch (...) {
+          return SQLITE_INTERNAL;
+        }
 
-    module.xSync = [](sqlite3_vtab* pVTab) noexcept { return SQLITE_OK; };
+        return SQLITE_OK;
+      };
 
-    module.xCommit = [](sqlite3_vtab* pVTab) noexcept { return SQLITE_OK; };
+      // NOTE: SQLite ignores errors from these two.
+      module.xCommit = [](sqlite3_vtab* pVTab) noexcept {
+        try {
+          auto p = unbox(pVTab);
+          p.vtab->changes_.clear();
+          p.vtab->savepoints_.clear();
 
-    module.xRollback = [](sqlite3_vtab* pVTab) noexcept { return SQLITE_OK; };
+          if constexpr (requires { p.vtab->xCommit(); }) {
+            p.vtab->xCommit();
+          }
+        } catch (...) {
+          return SQLITE_INTERNAL;
+        }
 
-    module.xRename = [](sqlite3_vtab* pVTab, const char* zNew) noexcept {
-      return SQLITE_OK;
-    };
+        return SQLITE_OK;
+      };
 
-    module.xSavepoint = [](sqlite3_vtab* pVTab, int iSavepoint) noexcept {
-      return SQLITE_OK;
-    };
+      module.xRollback = [](sqlite3_vtab* pVTab) noexcept {
+        try {
+          auto p = unbox(pVTab);
+          p.vtab->changes_.clear();
+          p.vtab->savepoints_.clear();
 
-    module.xRelease = [](sqlite3_vtab* pVTab, int iSavepoint) noexcept {
-      return SQLITE_OK;
-    };
+          if constexpr (requires { p.vtab->xRollback(); }) {
+            p.vtab->xRollback();
+          }
+        } catch (...) {
+          return SQLITE_INTERNAL;
+        }
+
+        return SQLITE_OK;
+      };
+
+      module.xSavepoint = [](sqlite3_vtab* pVTab, int iSavepoint) noexcept {
+        try {
+          auto p = unbox(pVTab);
+          auto& savepoints = p.vtab->savepoints_;
+          savepoints.resize(size_t(iSavepoint) + 1, p.vtab->changes_.size());
+          savepoints[size_t(iSavepoint)] = p.vtab->changes_.size();
+        } catch (std::bad_alloc const& e) {
+          return SQLITE_NOMEM;
+        }
+
+        return SQLITE_OK;
+      };
 
-    module.xRollbackTo = [](sqlite3_vtab* pVTab, int iSavepoint) noexcept {
+      module.xRelease = [](sqlite3_vtab* pVTab, int iSavepoint) noexcept {
+        auto p = unbox(pVTab);
+        auto& savepoints = p.vtab->savepoints_;
+        savepoints.resize(std::min(savepoints.size(), size_t(iSavepoint)));
+        return SQLITE_OK;
+      };
+
+      module.xRollbackTo = [](sqlite3_vtab* pVTab, int iSavepoint) noexcept {
+        auto p = unbox(pVTab);
+        auto& savepoints = p.vtab->savepoints_;
+
+        if (size_t(iSavepoint) < savepoints.size()) {
+          p.vtab->changes_.resize(savepoints[size_t(iSavepoint)]);
+          savepoints.resize(size_t(iSavepoint) + 1);
+        }
+
+        return SQLITE_OK;
+      };
+    }
+
+#if 0
+    module.xRename = [](sqlite3_vtab* pVTab, const char* zNew) noexcept {
       return SQLITE_OK;
     };
 
@@ -0,0 +1,99 @@
+#include "federlieb/federlieb.hxx"
+
+namespace fl = ::federlieb;
+
+fl::worker::worker(fl::db db, scheduler resume)
+  : db_(db)
+  , resume_(resume)
+  , thread_([this] { run(); })
+{}
+
+fl::worker::~worker()
+{
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+
+  wakeup_.notify_one();
+  thread_.join();
+}
+
+void
+fl::worker::post(std::function<void()> job)
+{
+  {
+    std::lock_guard lock(mutex_);
+    fl::error::raise_if(stopping_, "worker is stopping");
+    jobs_.push_back(std::move(job));
+  }
+
+  wakeup_.notify_one();
+}
+
+void
+fl::worker::cancel()
+{
+  fl::api(sqlite3_interrupt, db_.ptr().get(), db_.ptr().get());
+}
+
+void
+fl::worker::resume(std::coroutine_handle<> handle)
+{
+  if (resume_) {
+    resume_(handle);
+  } else {
+    handle.resume();
+  }
+}
+
+void
+fl::worker::run()
+{
+  for (;;) {
+    std::function<void()> job;
+
+    {
+      std::unique_lock lock(mutex_);
+      wakeup_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+
+      if (jobs_.empty()) {
+        return;
+      }
+
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    job();
+  }
+}
+
+void
+fl::batch_awaitable::await_suspend(std::coroutine_handle<> handle)
+{
+  worker_.post([this, handle] {
+    try {
+      if (stmt_.state_ == fl::stmt::state::prepared) {
+        stmt_.execute();
+      }
+
+      stmt_.fetch_batch(n_, batch_);
+
+    } catch (...) {
+      error_ = std::current_exception();
+    }
+
+    worker_.resume(handle);
+  });
+}
+
+fl::batch
+fl::batch_awaitable::await_resume()
+{
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+
+  return std::move(batch_);
+}
@@ -0,0 +1,92 @@
+#ifndef FEDERLIEB_WORKER_HXX
+#define FEDERLIEB_WORKER_HXX
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "api.hxx"
+
+#include "federlieb/batch.hxx"
+#include "federlieb/db.hxx"
+
+namespace federlieb {
+
+namespace fl = ::federlieb;
+
+class stmt;
+
+// A thread that runs jobs against one connection, one at a time, so that
+// stepping long-running statements does not block the caller. Awaiting
+// `fl::stmt::next_batch(worker)` suspends the coroutine, steps on the
+// worker thread, and resumes the coroutine through `resume`; by default
+// that happens right on the worker thread, event loops would pass a
+// function that posts the handle to the loop instead.
+//
+// Statements may be prepared on other threads while the worker runs, as
+// long as the connection was not opened with `SQLITE_OPEN_NOMUTEX`.
+// Jobs still queued when the worker is destroyed are run first.
+class worker
+{
+public:
+  using scheduler = std::function<void(std::coroutine_handle<>)>;
+
+  explicit worker(fl::db db, scheduler resume = {});
+  ~worker();
+
+  worker(const worker&) = delete;
+  worker& operator=(const worker&) = delete;
+
+  fl::db& db() { return db_; }
+
+  void post(std::function<void()> job);
+
+  // Interrupts whatever the connection is running right now, which makes
+  // the awaiting coroutine see an error. Queued jobs are not affected.
+  void cancel();
+
+  void resume(std::coroutine_handle<> handle);
+
+protected:
+  void run();
+
+  fl::db db_;
+  scheduler resume_;
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<std::function<void()>> jobs_;
+  bool stopping_ = false;
+
+  // NOTE: Declared last so everything above exists when the thread starts.
+  std::thread thread_;
+};
+
+class batch_awaitable
+{
+public:
+  batch_awaitable(fl::stmt& stmt, fl::worker& worker, size_t const n)
+    : stmt_(stmt)
+    , worker_(worker)
+    , n_(n)
+  {}
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle);
+  fl::batch await_resume();
+
+protected:
+  fl::stmt& stmt_;
+  fl::worker& worker_;
+  size_t n_;
+  fl::batch batch_;
+  std::exception_ptr error_;
+};
+
+}
+
+#endif
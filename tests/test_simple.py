@@ -8,6 +8,7 @@ import sqlite3 as sq
 import pytest
 import networkx
 import json
+import csv
 import warnings
 import random
 from typing import TypeAlias
@@ -89,6 +90,220 @@ def test_stmt_nocache(db: Db):
     assert first != second
 
 
+def test_stmt_stats(db: Db):
+    cur: Cursor = db.cursor()
+
+    cur.execute("SELECT COUNT(*) FROM fl_stmt_stats")
+    cur.execute("SELECT 1 AS profiled")
+    cur.execute("SELECT 1 AS profiled")
+
+    cur.execute(
+        """
+        SELECT runs, vm_steps > 0 FROM fl_stmt_stats
+        WHERE sql = 'SELECT 1 AS profiled'
+    """
+    )
+
+    assert cur.fetchall() == [(2, 1)]
+
+
+def test_partition_by_close(tmp_path):
+    # `sqlite3.Connection.close` uses `sqlite3_close_v2`, which leaves the
+    # connection open as a zombie when statements are still around. With
+    # an exclusive lock, a second connection can tell.
+    path = str(tmp_path / "partition_by.db")
+
+    db = sqlite3.connect(path)
+    db.enable_load_extension(True)
+    db.load_extension("build/fl_extensions")
+    db.enable_load_extension(False)
+
+    cur: Cursor = db.cursor()
+    cur.execute("PRAGMA locking_mode = EXCLUSIVE")
+    cur.execute("CREATE TABLE x(element)")
+    cur.executemany("INSERT INTO x VALUES(?)", [(i,) for i in range(1, 7)])
+    db.commit()
+
+    cur.execute(
+        """
+        CREATE VIRTUAL TABLE p USING fl_partition_by(
+            elements=(SELECT element FROM x),
+            once_by=(SELECT element, element % 2 FROM p),
+            then_by=(SELECT element, element % 3 FROM p)
+        )
+    """
+    )
+
+    cur.execute("SELECT COUNT(DISTINCT current) FROM p")
+    assert cur.fetchall() == [(6,)]
+
+    cur.close()
+    db.close()
+
+    other = sqlite3.connect(path)
+    assert other.execute("SELECT COUNT(*) FROM x").fetchall() == [(6,)]
+    other.close()
+
+
+def test_plan_decode(db: Db, monkeypatch):
+    # Without kept plans xFilter decodes each plan from `idxStr`, which
+    # raises when the plan does not encode the same again.
+    rows = [(1, 1), (2, 2.5), (3, "a"), (4, b"\x00\xff"), (5, None), (6, "[1]")]
+
+    queries = [
+        ("SELECT i FROM t WHERE v = 1", ()),
+        ("SELECT i FROM t WHERE v = 2.5", ()),
+        ("SELECT i FROM t WHERE v = 'a'", ()),
+        ("SELECT i FROM t WHERE v = X'00FF'", ()),
+        ("SELECT i FROM t WHERE v = json('[1]')", ()),
+        ("SELECT i FROM t WHERE v IS NULL", ()),
+        ("SELECT i FROM t WHERE v = (SELECT 'a')", ()),
+        ("SELECT i FROM t WHERE v = ?", (2.5,)),
+        ("SELECT i FROM t WHERE i IN (1, 3, 5)", ()),
+        ("SELECT i FROM t WHERE i > 1 ORDER BY i LIMIT 2 OFFSET 1", ()),
+        ("SELECT i FROM t LIMIT ? OFFSET ?", (3, 2)),
+    ]
+
+    def results(db: Db) -> list:
+        cur: Cursor = db.cursor()
+        cur.execute("CREATE TABLE x(i, v)")
+        cur.executemany("INSERT INTO x VALUES(?, ?)", rows)
+        cur.execute(
+            """
+            CREATE VIRTUAL TABLE t USING fl_stmt((
+                SELECT i, v FROM x
+            ), key=(SELECT 1))
+        """
+        )
+        return [sorted(cur.execute(sql, args).fetchall()) for sql, args in queries]
+
+    expected = results(db)
+
+    monkeypatch.setenv("FEDERLIEB_PLAN_CAPACITY", "0")
+
+    other = sqlite3.connect(":memory:")
+    other.enable_load_extension(True)
+    other.load_extension("build/fl_extensions")
+    other.enable_load_extension(False)
+
+    assert results(other) == expected
+    assert expected[3] == [(4,)]
+    assert expected[4] == [(6,)]
+    assert expected[10] == [(3,), (4,), (5,)]
+
+
+def test_kv_write(db: Db):
+    db.isolation_level = None
+    cur: Cursor = db.cursor()
+
+    cur.execute("CREATE VIRTUAL TABLE t USING fl_kv()")
+    cur.execute("INSERT INTO t VALUES ('a', 1), ('b', 2), ('c', 3)")
+    cur.execute("UPDATE t SET value = 20 WHERE key = 'b'")
+    cur.execute("DELETE FROM t WHERE key = 'c'")
+
+    cur.execute("SELECT rowid, key, value FROM t ORDER BY rowid")
+    assert cur.fetchall() == [(1, "a", 1), (2, "b", 20)]
+
+    with pytest.raises(sqlite3.DatabaseError):
+        cur.execute("INSERT INTO t VALUES ('d', 4), (NULL, 5)")
+
+    cur.execute("SELECT key FROM t ORDER BY rowid")
+    assert cur.fetchall() == [("a",), ("b",)]
+
+
+def test_kv_write_in_transaction(db: Db):
+    db.isolation_level = None
+    cur: Cursor = db.cursor()
+
+    cur.execute("CREATE VIRTUAL TABLE t USING fl_kv()")
+
+    cur.execute("BEGIN")
+    cur.execute("INSERT INTO t VALUES ('a', 1), ('b', 1)")
+    cur.execute("UPDATE t SET value = 2 WHERE key = 'a'")
+    cur.execute("DELETE FROM t WHERE key = 'b'")
+
+    cur.execute("SELECT key, value FROM t")
+    assert cur.fetchall() == [("a", 2)]
+
+    cur.execute("COMMIT")
+
+    cur.execute("SELECT key, value FROM t")
+    assert cur.fetchall() == [("a", 2)]
+
+    cur.execute("INSERT INTO t VALUES ('c', 3)")
+    assert cur.lastrowid == 3
+
+
+def test_kv_rollback_to(db: Db):
+    db.isolation_level = None
+    cur: Cursor = db.cursor()
+
+    cur.execute("CREATE VIRTUAL TABLE t USING fl_kv()")
+
+    cur.execute("BEGIN")
+    cur.execute("INSERT INTO t VALUES ('a', 1)")
+    cur.execute("SAVEPOINT s")
+    cur.execute("INSERT INTO t VALUES ('b', 2)")
+    cur.execute("ROLLBACK TO s")
+    cur.execute("INSERT INTO t VALUES ('c', 3)")
+    cur.execute("RELEASE s")
+    cur.execute("COMMIT")
+
+    cur.execute("SELECT key, value FROM t ORDER BY rowid")
+    assert cur.fetchall() == [("a", 1), ("c", 3)]
+
+    cur.execute("BEGIN")
+    cur.execute("INSERT INTO t VALUES ('d', 4)")
+    cur.execute("ROLLBACK")
+
+    cur.execute("SELECT key FROM t ORDER BY rowid")
+    assert cur.fetchall() == [("a",), ("c",)]
+
+
+def test_kv_failed_sync(db: Db):
+    db.isolation_level = None
+    cur: Cursor = db.cursor()
+
+    cur.execute("CREATE VIRTUAL TABLE t USING fl_kv()")
+    cur.execute("INSERT INTO t VALUES ('a', 1), ('b', 2)")
+
+    # Duplicate keys are found when SQLite commits, in xSync.
+    cur.execute("BEGIN")
+    cur.execute("INSERT INTO t VALUES ('c', 3)")
+    cur.execute("DELETE FROM t WHERE key = 'b'")
+    cur.execute("INSERT INTO t VALUES ('a', 4)")
+
+    with pytest.raises(sqlite3.DatabaseError):
+        cur.execute("COMMIT")
+
+    assert not db.in_transaction
+
+    cur.execute("SELECT key, value FROM t ORDER BY rowid")
+    assert cur.fetchall() == [("a", 1), ("b", 2)]
+
+
+def test_import_csv(db: Db, tmp_path):
+    path = tmp_path / "data.csv"
+    rows = [(str(i), f'say "{i}",\nagain' if i % 3 == 0 else "x") for i in range(1000)]
+
+    with open(path, "w", newline="") as f:
+        csv.writer(f).writerows([("id", "note"), *rows])
+
+    cur: Cursor = db.cursor()
+
+    cur.execute(
+        f"""
+        CREATE VIRTUAL TABLE t USING fl_import(
+            path={quote_string(str(path))}, threads=4, chunk_size=512
+        )
+    """
+    )
+
+    cur.execute("SELECT id, note FROM t")
+
+    assert cur.fetchall() == rows
+
+
 def test_dominator_tree(db: Db):
     count_vertices = 100
     count_edges = 3 * count_vertices
@@ -131,3 +346,221 @@ def test_dominator_tree(db: Db):
     rich.print(sorted(result))
 
     assert set(result) == set([x for x in pairs if x[0] != x[1]])
+
+
+def in_list_edges(db: Db, count_vertices: int = 30) -> list:
+    g = networkx.generators.gnm_random_graph(count_vertices, 3 * count_vertices, directed=True)
+    edges = [(u, v, random.randint(1, 9)) for u, v in g.edges]
+
+    cur: Cursor = db.cursor()
+    cur.execute("CREATE TABLE e(src, dst, weight REAL)")
+    cur.executemany("INSERT INTO e VALUES(?, ?, ?)", edges)
+
+    return edges
+
+
+def assert_in_list_matches(db: Db, sql: str, column: str, values: list):
+    # `sql` has `{}` where the constraint on `column` goes, results of one
+    # IN list must match those of one query per value.
+    cur: Cursor = db.cursor()
+
+    placeholders = ", ".join("?" * len(values))
+    cur.execute(sql.format(f"{column} IN ({placeholders})"), values)
+    together = sorted(cur.fetchall())
+
+    separately = []
+    for value in set(values):
+        cur.execute(sql.format(f"{column} = ?"), (value,))
+        separately += cur.fetchall()
+
+    assert together == sorted(separately)
+
+
+def test_dijkstra_in_list(db: Db):
+    in_list_edges(db)
+
+    db.execute(
+        """
+        CREATE VIRTUAL TABLE d USING fl_dijkstra_shortest_paths(
+            edges=(SELECT src, dst, weight FROM e)
+        )
+    """
+    )
+
+    sql = "SELECT source, vertex, predecessor, distance FROM d WHERE {}"
+
+    for values in [[], [0], [0, 1, 2], [3, 4, 3, 5], [1000]]:
+        assert_in_list_matches(db, sql, "source", values)
+
+    assert db.execute("SELECT COUNT(*) FROM d WHERE source IN ()").fetchall() == [(0,)]
+
+
+def test_dominator_tree_in_list(db: Db):
+    in_list_edges(db)
+
+    db.execute(
+        """
+        CREATE VIRTUAL TABLE d USING fl_dominator_tree(
+            edges=(SELECT src, dst FROM e)
+        )
+    """
+    )
+
+    sql = "SELECT root, vertex, immediate_dominator FROM d WHERE {}"
+
+    for values in [[], [0], [0, 1, 2], [3, 4, 3, 5]]:
+        assert_in_list_matches(db, sql, "root", values)
+
+    assert db.execute("SELECT COUNT(*) FROM d WHERE root IN ()").fetchall() == [(0,)]
+
+
+def test_stmt_in_list(db: Db):
+    in_list_edges(db)
+
+    db.execute(
+        """
+        CREATE VIRTUAL TABLE s USING fl_stmt((
+            SELECT dst, weight FROM e WHERE src = :p
+        ), key=(SELECT 1))
+    """
+    )
+
+    sql = 'SELECT ":p", dst, weight FROM s WHERE {}'
+
+    for values in [[], [0], [0, 1, 2], [3, 4, 3, 5], [1000]]:
+        assert_in_list_matches(db, sql, '":p"', values)
+
+    assert db.execute('SELECT COUNT(*) FROM s WHERE ":p" IN ()').fetchall() == [(0,)]
+
+
+def test_dijkstra_limit(db: Db):
+    edges = in_list_edges(db, 100)
+
+    g = networkx.DiGraph()
+    g.add_weighted_edges_from(edges)
+
+    db.execute(
+        """
+        CREATE VIRTUAL TABLE d USING fl_dijkstra_shortest_paths(
+            edges=(SELECT src, dst, weight FROM e)
+        )
+    """
+    )
+
+    source = random.choice(list(g.nodes))
+    distances = networkx.single_source_dijkstra_path_length(g, source)
+    expected = sorted(distances.values())
+
+    # Distances can tie, so rows are checked against networkx one by one
+    # and only the distances as a whole.
+    for limit, offset in [(1, 0), (10, 0), (10, 5), (len(g), 0), (10, len(g))]:
+        cur: Cursor = db.cursor()
+        cur.execute(
+            """
+            SELECT vertex, distance FROM d
+            WHERE source = ? AND distance IS NOT NULL
+            ORDER BY distance LIMIT ? OFFSET ?
+        """,
+            (source, limit, offset),
+        )
+
+        result = cur.fetchall()
+
+        assert [distance for _, distance in result] == expected[offset : offset + limit]
+        assert all(distances[vertex] == distance for vertex, distance in result)
+
+
+def test_stmt_limit(db: Db):
+    edges = in_list_edges(db)
+
+    db.execute(
+        """
+        CREATE VIRTUAL TABLE s USING fl_stmt((
+            SELECT dst, weight FROM e WHERE src = :p
+        ), key=(SELECT 1))
+    """
+    )
+
+    for p in range(10):
+        expected = {(v, w) for u, v, w in edges if u == p and w >= 5}
+
+        for limit in [1, 2, 100]:
+            cur: Cursor = db.cursor()
+            cur.execute(
+                """
+                SELECT dst, weight FROM s
+                WHERE ":p" = ? AND weight >= 5
+                LIMIT ?
+            """,
+                (p, limit),
+            )
+
+            result = cur.fetchall()
+
+            assert len(result) == min(limit, len(expected))
+            assert set(result) <= expected
+
+
+def test_transitive_closure(db: Db):
+    g = networkx.generators.gnm_random_graph(50, 60, directed=True)
+
+    # A vertex reaches itself only on a cycle, a self-loop is the shortest.
+    g.add_edges_from([(100, 101), (101, 102), (102, 100), (102, 103)])
+    g.add_edges_from([(104, 104), (104, 105)])
+
+    cur: Cursor = db.cursor()
+    cur.execute("CREATE TABLE e(src, dst)")
+    cur.executemany("INSERT INTO e VALUES(?, ?)", g.edges)
+
+    cur.execute(
+        """
+        CREATE VIRTUAL TABLE c USING fl_transitive_closure(
+            edges=(SELECT src, dst FROM e)
+        )
+    """
+    )
+
+    cur.execute("SELECT src, dst FROM c")
+    result = cur.fetchall()
+
+    expected = networkx.transitive_closure(g, reflexive=False).edges
+
+    assert len(result) == len(set(result))
+    assert set(result) == set(expected)
+    assert (100, 100) in result and (104, 104) in result
+    assert (103, 103) not in result and (105, 105) not in result
+
+
+def test_json_each(db: Db):
+    values = [1, "a", 2.5, None, [1, 2], {"b": 1}]
+    source = json.dumps(values)
+
+    cur: Cursor = db.cursor()
+
+    cur.execute("SELECT value FROM fl_json_each(?)", (source,))
+    assert cur.fetchall() == [
+        (1,),
+        ("a",),
+        (2.5,),
+        (None,),
+        ("[1,2]",),
+        ('{"b":1}',),
+    ]
+
+    cur.execute("SELECT json FROM fl_json_each(?)", (source,))
+    assert cur.fetchall() == [(source,)] * len(values)
+
+    cur.execute("SELECT value FROM fl_json_each('[1,2,3,4,5]') LIMIT 2 OFFSET 1")
+    assert cur.fetchall() == [(2,), (3,)]
+
+    cur.execute("SELECT COUNT(*) FROM fl_json_each('[]')")
+    assert cur.fetchall() == [(0,)]
+
+    # Each cursor has its own generator.
+    cur.execute(
+        """
+        SELECT a.value, b.value
+        FROM fl_json_each('[1,2]') a, fl_json_each('[3,4]') b
+    """
+    )
+    assert sorted(cur.fetchall()) == [(1, 3), (1, 4), (2, 3), (2, 4)]